@@ -0,0 +1,87 @@
+#pragma once
+
+#include "poker/card_set.hpp"
+#include "poker/isomorphism.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace poker {
+
+struct RankedCombo {
+    int combo = -1; // index from combo_index()
+    int score = 0;  // evaluate_hand score on the ranking's board
+};
+
+// Chip outcome for one holding against one opponent holding at showdown.
+struct ShowdownPayoffs {
+    double win = 0.0;
+    double lose = 0.0;
+    double tie = 0.0;
+};
+
+// All holdings that do not conflict with a 5-card river board, sorted weakest first,
+// with equal scores grouped. Built once per board and immutable afterwards, so one
+// instance can be shared by every showdown terminal (and thread) on that board.
+class BoardRanking {
+public:
+    explicit BoardRanking(const std::array<int, 5>& board);
+
+    const std::array<int, 5>& board() const { return board_; }
+    CardSet board_cards() const { return board_cards_; }
+
+    const std::vector<RankedCombo>& hands() const { return hands_; }
+
+    // Tie group g covers hands()[group_offsets()[g] .. group_offsets()[g + 1]).
+    const std::vector<int>& group_offsets() const { return group_offsets_; }
+    int num_groups() const { return static_cast<int>(group_offsets_.size()) - 1; }
+
+    // Score of a combo on this board, -1 if it shares a card with the board.
+    int score(int combo) const { return scores_[static_cast<std::size_t>(combo)]; }
+
+    // Showdown value of every holding against an opponent range in O(n):
+    // out[c] = sum over opponent combos o sharing no card with c (or the board) of
+    // opp_reach[o] * (win if c beats o, lose if o beats c, tie otherwise).
+    // opp_reach and out are indexed by combo (kNumCombos entries); conflicting combos get 0.
+    // Call once per player with that player's payoffs and the opponent's reach.
+    void showdown_values(const double* opp_reach, const ShowdownPayoffs& payoffs, double* out) const;
+    void showdown_values(const std::vector<double>& opp_reach, const ShowdownPayoffs& payoffs, std::vector<double>& out) const;
+
+private:
+    std::array<int, 5> board_{};
+    CardSet board_cards_;
+    std::vector<RankedCombo> hands_;
+    std::vector<int> group_offsets_;
+    std::vector<int> scores_;
+};
+
+// Ranking of the canonical board isomorphic to a requested board. Combos of the requested
+// board map into the ranking with apply_suit_permutation(cards, perm).
+struct CanonicalRanking {
+    std::shared_ptr<const BoardRanking> ranking;
+    SuitPermutation perm{0, 1, 2, 3};
+};
+
+// Thread-safe cache of rankings keyed by board card set, so every terminal node on the
+// same board (in any order of dealing) shares one ranking.
+class BoardRankingCache {
+public:
+    std::shared_ptr<const BoardRanking> get(const std::array<int, 5>& board);
+
+    // Shares one ranking among all suit-isomorphic boards (134,459 classes of river boards
+    // instead of 2,598,960).
+    CanonicalRanking get_canonical(const std::array<int, 5>& board);
+
+    std::size_t size() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::shared_ptr<const BoardRanking>> rankings_;
+};
+
+} // namespace poker
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace poker {
+
+namespace detail {
+
+inline int popcount64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for (; x != 0; x &= x - 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Index of the lowest set bit; x must be non-zero.
+inline int lowest_bit64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int i = 0;
+    for (; (x & 1) == 0; x >>= 1) {
+        ++i;
+    }
+    return i;
+#endif
+}
+
+} // namespace detail
+
+// Set of cards (0..51) as a 64-bit mask, bit `card` set for every member. Conflict
+// checks between sets are a single AND; iteration visits cards in ascending order.
+class CardSet {
+public:
+    static constexpr std::uint64_t kDeckMask = (std::uint64_t{1} << 52) - 1;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        constexpr iterator() = default;
+        constexpr explicit iterator(std::uint64_t rest) : rest_(rest) {}
+
+        int operator*() const { return detail::lowest_bit64(rest_); }
+        iterator& operator++() {
+            rest_ &= rest_ - 1;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        constexpr bool operator==(const iterator& o) const { return rest_ == o.rest_; }
+        constexpr bool operator!=(const iterator& o) const { return rest_ != o.rest_; }
+
+    private:
+        std::uint64_t rest_ = 0;
+    };
+
+    constexpr CardSet() = default;
+    constexpr explicit CardSet(std::uint64_t mask) : mask_(mask) {}
+
+    static constexpr CardSet of(int card) { return CardSet(std::uint64_t{1} << card); }
+    static constexpr CardSet of(const std::array<int, 2>& hole) { return of(hole[0]) | of(hole[1]); }
+    static constexpr CardSet full() { return CardSet(kDeckMask); }
+
+    template <typename Range>
+    static CardSet from(const Range& cards) {
+        CardSet s;
+        for (int c : cards) {
+            s.insert(c);
+        }
+        return s;
+    }
+
+    constexpr std::uint64_t mask() const { return mask_; }
+    constexpr bool empty() const { return mask_ == 0; }
+    int size() const { return detail::popcount64(mask_); }
+
+    constexpr bool contains(int card) const { return ((mask_ >> card) & 1) != 0; }
+    constexpr bool intersects(CardSet o) const { return (mask_ & o.mask_) != 0; }
+
+    void insert(int card) { mask_ |= std::uint64_t{1} << card; }
+    void erase(int card) { mask_ &= ~(std::uint64_t{1} << card); }
+
+    // Lowest card in the set; the set must not be empty.
+    int lowest() const { return detail::lowest_bit64(mask_); }
+
+    // The n-th lowest card (n < size()).
+    int nth(int n) const {
+        std::uint64_t rest = mask_;
+        for (; n > 0; --n) {
+            rest &= rest - 1;
+        }
+        return detail::lowest_bit64(rest);
+    }
+
+    // Cards of the deck not in this set.
+    constexpr CardSet complement() const { return CardSet(~mask_ & kDeckMask); }
+
+    iterator begin() const { return iterator(mask_); }
+    iterator end() const { return iterator(); }
+
+    constexpr CardSet operator|(CardSet o) const { return CardSet(mask_ | o.mask_); }
+    constexpr CardSet operator&(CardSet o) const { return CardSet(mask_ & o.mask_); }
+    constexpr CardSet operator-(CardSet o) const { return CardSet(mask_ & ~o.mask_); }
+    CardSet& operator|=(CardSet o) {
+        mask_ |= o.mask_;
+        return *this;
+    }
+    CardSet& operator&=(CardSet o) {
+        mask_ &= o.mask_;
+        return *this;
+    }
+    CardSet& operator-=(CardSet o) {
+        mask_ &= ~o.mask_;
+        return *this;
+    }
+    constexpr bool operator==(CardSet o) const { return mask_ == o.mask_; }
+    constexpr bool operator!=(CardSet o) const { return mask_ != o.mask_; }
+
+private:
+    std::uint64_t mask_ = 0;
+};
+
+} // namespace poker
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace poker {
+
+// Cards are encoded as suit * 13 + rank_index, with rank_index 0..12 for ranks 2..A.
+constexpr int kNumCards = 52;
+constexpr int kNumSuits = 4;
+constexpr int kNumRanks = 13;
+
+// Unordered hole-card pairs.
+constexpr int kNumCombos = kNumCards * (kNumCards - 1) / 2;
+
+constexpr int card_rank_index(int card) {
+    return card % kNumRanks;
+}
+
+constexpr int card_suit(int card) {
+    return card / kNumRanks;
+}
+
+constexpr int make_card(int rank_index, int suit) {
+    return suit * kNumRanks + rank_index;
+}
+
+// Colexicographic index of an unordered pair of distinct cards, 0..kNumCombos-1.
+constexpr int combo_index(int c0, int c1) {
+    const int lo = c0 < c1 ? c0 : c1;
+    const int hi = c0 < c1 ? c1 : c0;
+    return hi * (hi - 1) / 2 + lo;
+}
+
+namespace detail {
+
+constexpr std::array<std::array<int, 2>, kNumCombos> make_combo_table() {
+    std::array<std::array<int, 2>, kNumCombos> t{};
+    for (int hi = 1; hi < kNumCards; ++hi) {
+        for (int lo = 0; lo < hi; ++lo) {
+            t[static_cast<std::size_t>(combo_index(lo, hi))] = {lo, hi};
+        }
+    }
+    return t;
+}
+
+inline constexpr std::array<std::array<int, 2>, kNumCombos> kComboCards = make_combo_table();
+
+} // namespace detail
+
+// Cards of a combo index, lower card first.
+constexpr const std::array<int, 2>& combo_cards(int combo) {
+    return detail::kComboCards[static_cast<std::size_t>(combo)];
+}
+
+} // namespace poker
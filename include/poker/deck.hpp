@@ -0,0 +1,58 @@
+#pragma once
+
+#include "poker/rng.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace poker {
+
+// 52-card deck dealt by partial Fisher-Yates: each deal swaps a uniformly chosen undealt
+// card to the front of the undealt region, so every draw costs one RNG call no matter how
+// many cards are gone. Trivially copyable (53 bytes) and independent of the RNG type.
+class Deck {
+public:
+    Deck() { reset(); }
+
+    void reset() {
+        for (int c = 0; c < 52; ++c) {
+            cards_[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c);
+        }
+        dealt_ = 0;
+    }
+
+    int remaining() const { return 52 - dealt_; }
+
+    template <typename Rng>
+    int deal(Rng& rng) {
+        std::uint8_t from = 0;
+        return deal(rng, from);
+    }
+
+    // As deal(), also reporting the position the card was drawn from for undeal().
+    template <typename Rng>
+    int deal(Rng& rng, std::uint8_t& from) {
+        const std::size_t i = dealt_;
+        const std::size_t j = i + uniform_below(rng, static_cast<std::uint32_t>(remaining()));
+        const std::uint8_t card = cards_[j];
+        cards_[j] = cards_[i];
+        cards_[i] = card;
+        ++dealt_;
+        from = static_cast<std::uint8_t>(j);
+        return card;
+    }
+
+    // Reverts the most recent deal exactly, given the position it reported.
+    void undeal(std::uint8_t from) {
+        --dealt_;
+        const std::uint8_t card = cards_[dealt_];
+        cards_[dealt_] = cards_[from];
+        cards_[from] = card;
+    }
+
+private:
+    std::array<std::uint8_t, 52> cards_{};
+    std::uint8_t dealt_ = 0;
+};
+
+} // namespace poker
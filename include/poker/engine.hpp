@@ -1,37 +1,67 @@
 #pragma once
 
+#include "poker/rng.hpp"
+#include "poker/rules.hpp"
 #include "poker/types.hpp"
 
-#include <random>
+#include <cstdint>
 #include <vector>
 
 namespace poker {
 
-class Engine {
+// Convenience pairing of a Rules instance with one generator, for single-threaded callers.
+// Everything except dealing and random action choice forwards to the const Rules; threads
+// that share one Rules should each own their generator instead of an Engine.
+template <typename Rng>
+class BasicEngine {
 public:
-    explicit Engine(unsigned int seed = 42);
+    using rng_type = Rng;
 
-    State new_hand(int starting_stack = 1000, int small_blind = 5, int big_blind = 10);
+    explicit BasicEngine(std::uint64_t seed = 42, const RulesConfig& config = RulesConfig{})
+        : rules_(config), rng_(seed) {}
 
-    std::vector<Action> legal_actions(const State& state) const;
+    const Rules& rules() const { return rules_; }
 
-    bool apply_action(State& state, const Action& action);
+    State new_hand(int starting_stack = 1000, int small_blind = 5, int big_blind = 10) {
+        return rules_.new_hand(rng_, starting_stack, small_blind, big_blind);
+    }
 
-    TerminalResult terminal_payoff(const State& state) const;
+    std::vector<Action> legal_actions(const State& state) const { return rules_.legal_actions(state); }
+    void legal_actions(const State& state, ActionBuffer& out) const { rules_.legal_actions(state, out); }
 
-    int evaluate_7card(const std::array<int, 2>& hole, const std::vector<int>& board) const;
+    // False if the action is not legal in `state` or the action log is full.
+    bool apply_action(State& state, const Action& action) { return rules_.apply_action(state, action, rng_); }
 
-    Action random_legal_action(const State& state);
+    // Applies an action taken from legal_actions(state) without re-deriving the legal set.
+    // Legality and log capacity are only checked by assertions in debug builds.
+    void apply_action_unchecked(State& state, const Action& action) {
+        rules_.apply_action_unchecked(state, action, rng_);
+    }
 
-private:
-    std::mt19937 rng_;
+    // As above, recording what undo_action needs to revert the action (see Rules).
+    void apply_action_unchecked(State& state, const Action& action, UndoRecord& undo) {
+        rules_.apply_action_unchecked(state, action, rng_, undo);
+    }
+    void undo_action(State& state, const UndoRecord& undo) const { rules_.undo_action(state, undo); }
+
+    bool is_legal(const State& state, const Action& action) const { return rules_.is_legal(state, action); }
+
+    TerminalResult terminal_payoff(const State& state) const { return rules_.terminal_payoff(state); }
 
-    void advance_street(State& state);
-    void deal_remaining_board(State& state);
-    int draw_card(State& state);
+    int evaluate_7card(const std::array<int, 2>& hole, const std::vector<int>& board) const {
+        return rules_.evaluate_7card(hole, board);
+    }
+    int evaluate_7card(const std::array<int, 2>& hole, const Board& board) const {
+        return rules_.evaluate_7card(hole, board);
+    }
 
-    bool is_round_closed(const State& state) const;
-    int min_raise_to(const State& state) const;
+    Action random_legal_action(const State& state) { return rules_.random_legal_action(state, rng_); }
+
+private:
+    Rules rules_;
+    Rng rng_;
 };
 
+using Engine = BasicEngine<Xoshiro256StarStar>;
+
 } // namespace poker
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+struct RangeEntry {
+    std::array<int, 2> cards{};
+    double weight = 1.0;
+};
+
+using HandRange = std::vector<RangeEntry>;
+
+struct EquityOptions {
+    // Worker threads; 0 uses std::thread::hardware_concurrency().
+    int threads = 0;
+    std::uint64_t seed = 42;
+
+    // Enumerate every runout of every matchup when that costs at most this many showdowns,
+    // otherwise fall back to Monte Carlo.
+    std::uint64_t max_exact_showdowns = 20000000;
+
+    // Monte Carlo stops once the standard error of the hero equity is at or below the
+    // target, or after max_samples boards. Boards are drawn in whole chunks of 4096, so
+    // max_samples is rounded up to a multiple of 4096; EquityResult::showdowns is the count
+    // actually run.
+    double target_std_error = 0.001;
+    std::uint64_t max_samples = 50000000;
+};
+
+struct EquityResult {
+    double equity = 0.0; // hero win + tie / 2
+    double win = 0.0;
+    double tie = 0.0;
+    double std_error = 0.0; // 0 for exact results
+    std::uint64_t showdowns = 0;
+    bool exact = false;
+};
+
+// Hero equity against the villain on a board of 0, 3, 4 or 5 cards, averaged over all
+// card-compatible matchups weighted by weight product. Range entries that conflict with
+// the board are dropped. Results are deterministic for a given seed regardless of the
+// thread count. Throws std::invalid_argument for malformed input or when no matchup is
+// possible.
+EquityResult hand_vs_hand(const std::array<int, 2>& hero, const std::array<int, 2>& villain,
+                          const std::vector<int>& board, const EquityOptions& options = EquityOptions{});
+
+EquityResult hand_vs_range(const std::array<int, 2>& hero, const HandRange& villain,
+                           const std::vector<int>& board, const EquityOptions& options = EquityOptions{});
+
+EquityResult range_vs_range(const HandRange& hero, const HandRange& villain,
+                            const std::vector<int>& board, const EquityOptions& options = EquityOptions{});
+
+} // namespace poker
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace poker {
+
+// Inline, fixed-capacity sequence with the subset of the std::vector interface the engine
+// uses. Storage lives in the object, so a FixedVector of trivially copyable T is itself
+// trivially copyable and copies never touch the heap.
+template <typename T, std::size_t N>
+class FixedVector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_type capacity() { return N; }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+
+    void push_back(const T& value) {
+        assert(size_ < N);
+        items_[size_++] = value;
+    }
+    void pop_back() {
+        assert(size_ > 0);
+        --size_;
+    }
+    void clear() { size_ = 0; }
+
+    T& operator[](size_type i) { return items_[i]; }
+    const T& operator[](size_type i) const { return items_[i]; }
+    T& back() { return items_[size_ - 1]; }
+    const T& back() const { return items_[size_ - 1]; }
+
+    T* data() { return items_.data(); }
+    const T* data() const { return items_.data(); }
+    iterator begin() { return items_.data(); }
+    iterator end() { return items_.data() + size_; }
+    const_iterator begin() const { return items_.data(); }
+    const_iterator end() const { return items_.data() + size_; }
+
+    std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+private:
+    std::array<T, N> items_{};
+    size_type size_ = 0;
+};
+
+} // namespace poker
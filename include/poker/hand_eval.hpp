@@ -0,0 +1,81 @@
+#pragma once
+
+#include "poker/card_set.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+// Direct 7-card hand evaluator.
+//
+// Scores use the fixed-width base-15 packing of the original best-of-21 evaluator:
+// category in [0..8] (high card .. straight flush) followed by exactly five kicker
+// slots holding ranks 2..14. Larger is better and equal hands score equal, so
+// results can be compared against any score produced by Engine::evaluate_7card.
+//
+// Evaluation is branch-light table lookups over 13-bit rank masks and never allocates.
+
+// Cards are encoded as suit * 13 + rank_index (0..51); bit `card` of the mask is set
+// for every card held. Accepts five to seven distinct cards.
+int evaluate_card_mask(std::uint64_t card_mask);
+
+inline int evaluate_cards(CardSet cards) {
+    return evaluate_card_mask(cards.mask());
+}
+
+int evaluate_7cards(const std::array<int, 7>& cards);
+
+int evaluate_hand(const std::array<int, 2>& hole, const std::array<int, 5>& board);
+
+// Scores every hole-card pair against one 5-card board, writing out[i] for holes[i].
+// Holdings that share a card with the board (or repeat a card) score -1.
+// Uses an AVX2 kernel when the CPU supports it and a portable scalar loop otherwise;
+// both return exactly the scores of evaluate_hand.
+void evaluate_board_batch(const std::array<int, 5>& board, const std::array<int, 2>* holes, std::size_t count, int* out);
+void evaluate_board_batch(const std::array<int, 5>& board, const std::vector<std::array<int, 2>>& holes, std::vector<int>& out);
+
+// Incremental evaluator state for enumerating runouts. Start from the hole cards plus a
+// partial board, add cards one at a time, and score the final card with score_with()
+// without rebuilding the shared cards. Keeps the card set and the rank multiplicity
+// masks (ranks held at least once, twice, three and four times); copies are 24 bytes.
+class HandAccumulator {
+public:
+    HandAccumulator() = default;
+    explicit HandAccumulator(CardSet cards);
+    HandAccumulator(const std::array<int, 2>& hole, const std::vector<int>& board);
+
+    void add(int card) {
+        const std::uint32_t b = 1u << (card % 13);
+        for (std::uint32_t& level : levels_) {
+            if ((level & b) == 0) {
+                level |= b;
+                break;
+            }
+        }
+        cards_.insert(card);
+    }
+
+    HandAccumulator with(int card) const {
+        HandAccumulator next = *this;
+        next.add(card);
+        return next;
+    }
+
+    bool contains(int card) const { return cards_.contains(card); }
+    CardSet cards() const { return cards_; }
+
+    // Score of the cards added so far (five to seven cards).
+    int score() const;
+
+    // Score after adding `card`, which must not already be held; the state is unchanged.
+    int score_with(int card) const;
+
+private:
+    CardSet cards_;
+    std::array<std::uint32_t, 4> levels_{};
+};
+
+} // namespace poker
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+// perm[original_suit] = canonical suit.
+using SuitPermutation = std::array<int, 4>;
+
+int apply_suit_permutation(int card, const SuitPermutation& perm);
+std::array<int, 2> apply_suit_permutation(const std::array<int, 2>& hole, const SuitPermutation& perm);
+SuitPermutation inverse_permutation(const SuitPermutation& perm);
+
+// Canonical suit relabelling for cards dealt in rounds (for example hole cards, flop,
+// turn). Cards inside a round are unordered; rounds are not interchangeable. Suits are
+// ordered by their per-round rank masks, so every strategically identical deal maps to
+// the same canonical cards. Suits that stay indistinguishable keep their relative order.
+SuitPermutation canonical_permutation(const std::vector<std::uint64_t>& round_masks);
+
+struct CanonicalBoard {
+    std::vector<int> cards; // canonical cards, ascending
+    SuitPermutation perm{0, 1, 2, 3};
+    std::uint64_t key = 0; // canonical card mask; equal for isomorphic boards
+};
+
+CanonicalBoard canonicalize_board(const std::vector<int>& board);
+
+// Board plus holdings canonicalized jointly: the board is one round and each holding its
+// own round, so (board, holdings) pairs that differ only by suit names share one form.
+struct CanonicalSpot {
+    CanonicalBoard board;
+    std::vector<std::array<int, 2>> holdings; // mapped with board.perm, each ascending
+};
+
+CanonicalSpot canonicalize(const std::vector<int>& board, const std::vector<std::array<int, 2>>& holdings);
+
+struct WeightedBoard {
+    std::vector<int> cards;
+    int weight = 0; // number of concrete boards in the class
+};
+
+// One representative per isomorphism class of unordered boards of `num_cards` cards,
+// ordered by canonical key. 3 cards gives the 1755 canonical flops (weights sum to 22100).
+std::vector<WeightedBoard> canonical_boards(int num_cards);
+
+struct WeightedCard {
+    int card = -1;  // representative in the suits of the given board
+    int weight = 0; // number of concrete cards it stands for
+};
+
+// Distinct next cards for a chance node on `board` (the new card is its own round).
+std::vector<WeightedCard> canonical_next_cards(const std::vector<int>& board);
+
+} // namespace poker
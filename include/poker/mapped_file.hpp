@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace poker {
+
+// Read-only memory mapping of a whole file. Pages are shared through the page cache, so
+// several processes mapping the same file cost one copy in RAM.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    static MappedFile open(const std::string& path);
+
+    const unsigned char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool is_open() const { return data_ != nullptr; }
+
+private:
+    void reset();
+
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace poker
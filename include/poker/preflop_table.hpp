@@ -0,0 +1,66 @@
+#pragma once
+
+#include "poker/mapped_file.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker {
+
+// Canonical preflop hand classes on the 13x13 grid: pairs on the diagonal, suited hands at
+// [high][low] and offsuit hands at [low][high], using rank indices 0..12 (2..A).
+constexpr int kNumPreflopClasses = 169;
+
+int preflop_class(const std::array<int, 2>& hole);
+std::string preflop_class_name(int cls);
+
+// On-disk layout: this header followed by kNumPreflopClasses^2 floats, row major, entry
+// [hero * 169 + villain] = hero all-in equity averaged over every card-compatible combo
+// pair of the two classes. Everything is in the writer's byte order, which byte_order
+// records; a file from a different byte order is rejected.
+struct PreflopTableHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_classes;
+    std::uint32_t flags;
+    std::uint32_t byte_order; // kPreflopTableByteOrder as written
+    std::uint64_t samples_per_matchup; // 0 when every matchup was enumerated exactly
+    std::uint64_t checksum;            // FNV-1a of the equity payload
+};
+
+constexpr std::uint32_t kPreflopTableVersion = 2;
+constexpr std::uint32_t kPreflopTableByteOrder = 0x01020304;
+constexpr std::uint32_t kPreflopTableExact = 1u << 0;
+
+// Writes a table file; throws std::runtime_error on I/O failure.
+void write_preflop_table(const std::string& path, const std::vector<float>& equities, std::uint64_t samples_per_matchup);
+
+// Memory-mapped preflop all-in equity table. Lookups are a single indexed read.
+class PreflopEquityTable {
+public:
+    PreflopEquityTable() = default;
+
+    // Maps and validates the file (magic, version, byte order, size, checksum).
+    // Throws std::runtime_error on any mismatch.
+    static PreflopEquityTable open(const std::string& path);
+
+    bool loaded() const { return equities_ != nullptr; }
+    bool exact() const { return (header().flags & kPreflopTableExact) != 0; }
+    const PreflopTableHeader& header() const;
+
+    float equity(int hero_class, int villain_class) const {
+        return equities_[hero_class * kNumPreflopClasses + villain_class];
+    }
+
+    float equity(const std::array<int, 2>& hero, const std::array<int, 2>& villain) const {
+        return equity(preflop_class(hero), preflop_class(villain));
+    }
+
+private:
+    MappedFile file_;
+    const float* equities_ = nullptr;
+};
+
+} // namespace poker
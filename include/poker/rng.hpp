@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace poker {
+
+// Small, fast generators for simulation. Each models UniformRandomBitGenerator, so they
+// also work with the <random> distributions, and copies are a few words of state.
+
+// Stateless 64-bit mixer (SplitMix64 finalizer); also used to derive seeds.
+constexpr std::uint64_t split_mix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// SplitMix64 as a generator: 8 bytes of state, a counter advanced by a constant and mixed.
+// Cheap to seed per stream (one state per simulated hand or lane).
+class SplitMix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit SplitMix64(std::uint64_t seed = 0) : state_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t x = state_;
+        state_ += 0x9e3779b97f4a7c15ULL;
+        return split_mix64(x);
+    }
+
+    std::uint64_t state() const { return state_; }
+
+private:
+    std::uint64_t state_ = 0;
+};
+
+// xoshiro256** (Blackman & Vigna): 32 bytes of state, 64-bit output.
+class Xoshiro256StarStar {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256StarStar(std::uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(std::uint64_t seed) {
+        for (auto& w : s_) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            w = split_mix64(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        const std::uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::array<std::uint64_t, 4> s_{};
+};
+
+// PCG32 (XSH RR variant, O'Neill): 16 bytes of state, 32-bit output, selectable stream.
+class Pcg32 {
+public:
+    using result_type = std::uint32_t;
+
+    explicit Pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        this->seed(seed, stream);
+    }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        state_ = 0;
+        inc_ = (stream << 1) | 1;
+        (*this)();
+        state_ += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t old = state_;
+        state_ = old * 6364136223846793005ULL + inc_;
+        const auto xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rot = static_cast<std::uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+private:
+    std::uint64_t state_ = 0;
+    std::uint64_t inc_ = 1;
+};
+
+// Uniform integer in [0, n) for n > 0 without division in the common case (Lemire's
+// multiply-shift with rejection of the biased low range).
+template <typename Rng>
+std::uint32_t uniform_below(Rng& rng, std::uint32_t n) {
+    const auto draw = [&rng]() -> std::uint32_t {
+        if constexpr (sizeof(typename Rng::result_type) > 4) {
+            return static_cast<std::uint32_t>(rng() >> 32);
+        } else {
+            return static_cast<std::uint32_t>(rng());
+        }
+    };
+    std::uint64_t m = static_cast<std::uint64_t>(draw()) * n;
+    auto low = static_cast<std::uint32_t>(m);
+    if (low < n) {
+        const std::uint32_t threshold = (0u - n) % n;
+        while (low < threshold) {
+            m = static_cast<std::uint64_t>(draw()) * n;
+            low = static_cast<std::uint32_t>(m);
+        }
+    }
+    return static_cast<std::uint32_t>(m >> 32);
+}
+
+// Uniform double in [0, 1) with 53 random bits, the same on every standard library (the
+// <random> distributions are implementation-defined).
+template <typename Rng>
+double uniform_unit(Rng& rng) {
+    std::uint64_t bits;
+    if constexpr (sizeof(typename Rng::result_type) > 4) {
+        bits = static_cast<std::uint64_t>(rng()) >> 11;
+    } else {
+        bits = (static_cast<std::uint64_t>(rng()) << 21) ^ (static_cast<std::uint64_t>(rng()) >> 11);
+    }
+    return static_cast<double>(bits) * 0x1.0p-53;
+}
+
+} // namespace poker
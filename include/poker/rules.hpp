@@ -0,0 +1,124 @@
+#pragma once
+
+#include "poker/rng.hpp"
+#include "poker/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace poker {
+
+struct RulesConfig {
+    int starting_stack = 1000;
+    int small_blind = 5;
+    int big_blind = 10;
+    // Bet and raise sizes as fractions of the pot, the same on every street.
+    std::array<double, 3> bet_sizes{0.5, 1.0, 2.0};
+    int max_raises_per_street = std::numeric_limits<int>::max();
+    bool allow_all_in = true;
+
+    // Abstraction interface of rules_core.hpp.
+    template <typename F>
+    void for_each_size(int /*street*/, bool /*raise*/, int pot, F&& f) const {
+        for (double x : bet_sizes) {
+            f(static_cast<int>(pot * x));
+        }
+    }
+};
+
+// Upper bound on the actions of one hand under `config` with the given stack and blinds:
+// two passive actions per street, one final all-in, and every other bet or raise, each of
+// which grows the pot by at least the smallest size of it (and at least one chip) until
+// both stacks are in, or the raise cap times four streets if that is lower.
+std::size_t max_hand_actions(const RulesConfig& config, int starting_stack, int small_blind, int big_blind);
+
+// What apply_action_unchecked changed beyond the action itself, so undo_action can restore
+// the State exactly without a copy: the betting fields the action overwrote, the chips it
+// put in, and the board cards it dealt with their deck positions.
+struct UndoRecord {
+    Street street = Street::Preflop;
+    int to_act = 0;
+    int bet_to_call = 0;
+    int last_bet_size = 0;
+    int current_bet = 0;
+    std::array<int, 2> committed_this_round{0, 0};
+    std::array<bool, 2> acted_this_round{false, false};
+    int raises_this_street = 0;
+    std::uint64_t hash = 0;
+    int put = 0;
+    std::uint8_t board_size = 0;
+    std::array<std::uint8_t, 5> deal_from{};
+};
+
+// Heads-up no-limit rules: the betting of rules_core.hpp plus dealing. A Rules object is
+// immutable after construction and holds no random state: every operation that deals
+// cards takes the caller's generator, which draws from the State's own Deck. One instance
+// can therefore be shared by any number of threads, each with its own generator.
+// Operations taking an Rng are instantiated for Xoshiro256StarStar and Pcg32.
+class Rules {
+public:
+    Rules() = default;
+    // Throws std::invalid_argument if a hand could outgrow the State action log
+    // (max_hand_actions above kMaxHistory).
+    explicit Rules(const RulesConfig& config);
+
+    const RulesConfig& config() const { return config_; }
+
+    template <typename Rng>
+    State new_hand(Rng& rng) const {
+        return new_hand(rng, config_.starting_stack, config_.small_blind, config_.big_blind);
+    }
+    // Throws std::invalid_argument if, with this stack and blinds, a hand could outgrow
+    // the action log.
+    template <typename Rng>
+    State new_hand(Rng& rng, int starting_stack, int small_blind, int big_blind) const;
+
+    std::vector<Action> legal_actions(const State& state) const;
+    void legal_actions(const State& state, ActionBuffer& out) const;
+    bool is_legal(const State& state, const Action& action) const;
+
+    // False if the action is not legal in `state` or the action log is full.
+    template <typename Rng>
+    bool apply_action(State& state, const Action& action, Rng& rng) const;
+
+    // Applies an action taken from legal_actions(state) without re-deriving the legal set.
+    // Legality and log capacity are only checked by assertions in debug builds.
+    template <typename Rng>
+    void apply_action_unchecked(State& state, const Action& action, Rng& rng) const {
+        UndoRecord undo;
+        apply_action_unchecked(state, action, rng, undo);
+    }
+
+    // As above, recording in `undo` what undo_action needs to revert the action.
+    template <typename Rng>
+    void apply_action_unchecked(State& state, const Action& action, Rng& rng, UndoRecord& undo) const;
+
+    // Reverts the last action of `state`, which must have been applied with `undo`. Actions
+    // are undone in reverse order; the State, deck order included, is restored exactly.
+    void undo_action(State& state, const UndoRecord& undo) const;
+
+    template <typename Rng>
+    Action random_legal_action(const State& state, Rng& rng) const {
+        ActionBuffer legals;
+        legal_actions(state, legals);
+        return legals[uniform_below(rng, static_cast<std::uint32_t>(legals.size()))];
+    }
+
+    TerminalResult terminal_payoff(const State& state) const;
+
+    int evaluate_7card(const std::array<int, 2>& hole, const std::vector<int>& board) const;
+    int evaluate_7card(const std::array<int, 2>& hole, const Board& board) const;
+
+private:
+    RulesConfig config_;
+
+    template <typename Rng>
+    int draw_card(State& state, Rng& rng) const;
+    template <typename Rng>
+    void deal_board(State& state, std::size_t cards, Rng& rng, UndoRecord& undo) const;
+};
+
+} // namespace poker
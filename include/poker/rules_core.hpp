@@ -0,0 +1,234 @@
+#pragma once
+
+#include "poker/types.hpp"
+#include "poker/zobrist.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Heads-up no-limit betting rules shared by the dealing engine (Rules, on State) and the
+// tree builder (on TreeState). Only chips and turn order live here; cards are the caller's
+// business, driven by the Outcome of each action.
+//
+// A state type S has the betting fields of State/TreeState: street, pot, stacks, to_act,
+// bet_to_call, last_bet_size, current_bet, committed_this_round, committed_total, folded,
+// acted_this_round, raises_this_street and hash, which every function here keeps current
+// except for cards (see zobrist.hpp).
+//
+// An abstraction A provides max_raises_per_street, allow_all_in and
+// for_each_size(street_index, raise, pot, f), which calls f(chips) with each pot fraction
+// of `pot` offered for a bet (raise == false) or a raise on that street, in order.
+namespace poker::core {
+
+enum class Outcome {
+    Continue,   // next player to act on the same street
+    NextStreet, // round closed; the state is on the next street, whose cards are still to come
+    Showdown,   // river closed or a player is all in; street is Terminal, board to complete
+    Fold        // street is Terminal
+};
+
+constexpr int street_index(Street s) { return static_cast<int>(s); }
+
+template <typename S>
+void post_blinds(S& s, int starting_stack, int small_blind, int big_blind) {
+    // Heads-up: SB is player 0 and acts first preflop, BB is player 1.
+    s.street = Street::Preflop;
+    s.stacks = {starting_stack - small_blind, starting_stack - big_blind};
+    s.committed_this_round = {small_blind, big_blind};
+    s.committed_total = {small_blind, big_blind};
+    s.pot = small_blind + big_blind;
+    s.current_bet = big_blind;
+    s.bet_to_call = big_blind - small_blind;
+    s.last_bet_size = big_blind - small_blind;
+    s.to_act = 0;
+    s.acted_this_round = {false, false};
+    s.raises_this_street = 0;
+    s.hash = zobrist::betting_hash(s);
+}
+
+template <typename S>
+int call_amount(const S& s) {
+    return std::max(0, s.current_bet - s.committed_this_round[static_cast<std::size_t>(s.to_act)]);
+}
+
+template <typename S, typename A>
+void legal_actions(const S& s, const A& ab, ActionBuffer& out) {
+    out.clear();
+    const int si = street_index(s.street);
+    if (si < 0 || si > 3) {
+        return;
+    }
+
+    const int p = s.to_act;
+    const int stack = s.stacks[static_cast<std::size_t>(p)];
+    const int call = call_amount(s);
+    const bool may_raise = s.raises_this_street < ab.max_raises_per_street;
+
+    if (call > 0) {
+        out.add(Action{p, ActionType::Fold, 0, call, s.street});
+        out.add(Action{p, ActionType::Call, std::min(call, stack), call, s.street});
+
+        if (stack > call && may_raise) {
+            const int min_to = s.current_bet + std::max(1, s.last_bet_size);
+            ab.for_each_size(si, true, s.pot, [&](int chips) {
+                const int target = std::max(min_to, s.current_bet + chips);
+                const int needed = target - s.committed_this_round[static_cast<std::size_t>(p)];
+                if (needed > call && needed < stack) {
+                    out.add(Action{p, ActionType::Raise, needed, call, s.street});
+                }
+            });
+            if (ab.allow_all_in) {
+                out.add(Action{p, ActionType::Raise, stack, call, s.street});
+            }
+        }
+    } else {
+        out.add(Action{p, ActionType::Check, 0, 0, s.street});
+
+        if (stack > 0 && may_raise) {
+            ab.for_each_size(si, false, s.pot, [&](int chips) {
+                const int amount = std::max(1, chips);
+                if (amount < stack) {
+                    out.add(Action{p, ActionType::Bet, amount, 0, s.street});
+                }
+            });
+            if (ab.allow_all_in) {
+                out.add(Action{p, ActionType::Bet, stack, 0, s.street});
+            }
+        }
+    }
+}
+
+template <typename S, typename A>
+bool is_legal(const S& s, const A& ab, const Action& action) {
+    ActionBuffer legals;
+    legal_actions(s, ab, legals);
+    return std::any_of(legals.begin(), legals.end(), [&](const Action& a) {
+        return a.type == action.type && a.amount == action.amount && a.player == action.player;
+    });
+}
+
+namespace detail {
+
+// Assigns a hashed betting field, updating the hash to match. pot and bet_to_call follow
+// from the hashed fields and are assigned directly.
+template <typename S, typename T>
+void set(S& s, T& field, T value, std::uint32_t zobrist_field) {
+    s.hash += zobrist::key(zobrist_field, static_cast<int>(value)) -
+              zobrist::key(zobrist_field, static_cast<int>(field));
+    field = value;
+}
+
+template <typename S, typename T>
+void set(S& s, std::size_t p, std::array<T, 2>& field, T value, std::uint32_t zobrist_field) {
+    set(s, field[p], value, zobrist_field + static_cast<std::uint32_t>(p));
+}
+
+template <typename S>
+void clear_round(S& s) {
+    s.bet_to_call = 0;
+    set(s, s.current_bet, 0, zobrist::CurrentBet);
+    set(s, s.last_bet_size, 0, zobrist::LastBetSize);
+    for (std::size_t p = 0; p < 2; ++p) {
+        set(s, p, s.committed_this_round, 0, zobrist::Round);
+        set(s, p, s.acted_this_round, false, zobrist::Acted);
+    }
+}
+
+// The round closes once both players have acted and their commitments match, so the big
+// blind keeps the option after a limp.
+template <typename S>
+bool round_closed(const S& s) {
+    return s.committed_this_round[0] == s.committed_this_round[1] && s.acted_this_round[0] && s.acted_this_round[1];
+}
+
+template <typename S>
+bool all_in(const S& s) {
+    return !s.folded[0] && !s.folded[1] && (s.stacks[0] == 0 || s.stacks[1] == 0);
+}
+
+template <typename S>
+Outcome close_round(S& s) {
+    clear_round(s);
+    set(s, s.raises_this_street, 0, zobrist::Raises);
+    set(s, s.to_act, 0, zobrist::ToAct); // postflop the out-of-position player (player 0) acts first
+    if (s.street == Street::River) {
+        set(s, s.street, Street::Terminal, zobrist::StreetNumber);
+        return Outcome::Showdown;
+    }
+    set(s, s.street, static_cast<Street>(street_index(s.street) + 1), zobrist::StreetNumber);
+    return Outcome::NextStreet;
+}
+
+template <typename S>
+Outcome finish_all_in(S& s) {
+    clear_round(s);
+    set(s, s.street, Street::Terminal, zobrist::StreetNumber);
+    set(s, s.to_act, 0, zobrist::ToAct);
+    return Outcome::Showdown;
+}
+
+} // namespace detail
+
+// Applies a legal action's betting consequences. Does not validate `a`.
+template <typename S>
+Outcome apply_action(S& s, const Action& a) {
+    using detail::set;
+    const auto p = static_cast<std::size_t>(a.player);
+    const std::size_t opp = 1 - p;
+    const int opp_player = static_cast<int>(opp);
+
+    if (a.type == ActionType::Fold) {
+        set(s, p, s.folded, true, zobrist::Folded);
+        detail::clear_round(s);
+        set(s, s.street, Street::Terminal, zobrist::StreetNumber);
+        set(s, s.to_act, opp_player, zobrist::ToAct);
+        return Outcome::Fold;
+    }
+
+    if (a.type == ActionType::Check) {
+        set(s, p, s.acted_this_round, true, zobrist::Acted);
+        if (detail::round_closed(s)) {
+            return detail::close_round(s);
+        }
+        set(s, s.to_act, opp_player, zobrist::ToAct);
+        s.bet_to_call = std::max(0, s.current_bet - s.committed_this_round[opp]);
+        return Outcome::Continue;
+    }
+
+    const int put = std::min(a.amount, s.stacks[p]);
+    set(s, p, s.stacks, s.stacks[p] - put, zobrist::Stack);
+    set(s, p, s.committed_this_round, s.committed_this_round[p] + put, zobrist::Round);
+    set(s, p, s.committed_total, s.committed_total[p] + put, zobrist::Total);
+    s.pot += put;
+    set(s, p, s.acted_this_round, true, zobrist::Acted);
+
+    if (a.type == ActionType::Call) {
+        if (detail::all_in(s)) {
+            return detail::finish_all_in(s);
+        }
+        if (detail::round_closed(s)) {
+            return detail::close_round(s);
+        }
+        set(s, s.to_act, opp_player, zobrist::ToAct);
+        s.bet_to_call = std::max(0, s.current_bet - s.committed_this_round[opp]);
+        return Outcome::Continue;
+    }
+
+    // Bet or raise.
+    const int prior_current = s.current_bet;
+    set(s, s.current_bet, std::max(s.current_bet, s.committed_this_round[p]), zobrist::CurrentBet);
+    set(s, s.last_bet_size, std::max(1, s.current_bet - prior_current), zobrist::LastBetSize);
+    s.bet_to_call = std::max(0, s.current_bet - s.committed_this_round[opp]);
+    set(s, opp, s.acted_this_round, false, zobrist::Acted);
+    set(s, s.raises_this_street, s.raises_this_street + 1, zobrist::Raises);
+    set(s, s.to_act, opp_player, zobrist::ToAct);
+
+    if (detail::all_in(s)) {
+        return detail::finish_all_in(s);
+    }
+    return Outcome::Continue;
+}
+
+} // namespace poker::core
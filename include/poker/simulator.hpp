@@ -0,0 +1,55 @@
+#pragma once
+
+#include "poker/rules.hpp"
+#include "poker/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace poker {
+
+struct SimulationOptions {
+    std::uint64_t hands = 1000000;
+    int threads = 0;                  // 0 = hardware concurrency
+    std::uint64_t seed = 1;
+    std::uint64_t chunk_hands = 65536; // hands per scheduling unit
+};
+
+// Integer totals, so merging per-thread results is exact and independent of scheduling.
+struct SimulationStats {
+    std::uint64_t hands = 0;
+    std::uint64_t folds = 0;
+    std::uint64_t showdowns = 0;
+    std::uint64_t split_pots = 0;
+    std::uint64_t actions = 0;
+    std::int64_t p0_chips = 0;           // sum of player 0 chip deltas
+    std::uint64_t p0_chips_squared = 0;  // sum of squared player 0 chip deltas
+
+    void merge(const SimulationStats& o);
+
+    double fold_rate() const;
+    double showdown_rate() const;
+    // Player 0 mean chip result per hand and its standard error; player 1 is the negation.
+    double p0_ev() const;
+    double p0_ev_std_error() const;
+};
+
+// Called for every finished hand; `hand` is its global index. Invoked from worker threads,
+// so an observer that is not thread-safe must be used with threads = 1.
+using HandObserver = std::function<void(std::uint64_t hand, const State& state, const TerminalResult& result)>;
+
+// Random-policy self-play: both players pick uniformly among legal actions. Hands are
+// split into chunks that idle workers claim from a shared counter; every chunk seeds its
+// own generator from (seed, chunk index), so hand `i` is the same deal and action sequence
+// for any thread count. Throws std::invalid_argument if the rules allow hands longer than
+// the State action log (see max_hand_actions).
+SimulationStats simulate(const Rules& rules, const SimulationOptions& options, const HandObserver& observer = {});
+
+// The same self-play on a StateBatch of `lanes` hands per thread, advanced in lock step;
+// a finished lane is refilled with the next hand of the thread's chunk. Every hand seeds
+// its own stream from (seed, hand index), so results do not depend on threads or lanes
+// (they are a different sample than simulate()).
+SimulationStats simulate_batched(const Rules& rules, const SimulationOptions& options, std::size_t lanes);
+
+} // namespace poker
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "poker/rules.hpp"
+#include "poker/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace poker {
+
+// Action choices of a batched hand. The sizes are RulesConfig::bet_sizes in order; every
+// choice maps to exactly one Rules action (see StateBatch::action).
+enum class BatchAction : std::uint8_t {
+    Fold,
+    CheckCall,
+    Size0,
+    Size1,
+    Size2,
+    AllIn
+};
+
+constexpr int kBatchActions = 6;
+
+// Weights of a simple stationary policy over the batch actions; each lane picks among its
+// legal actions with probability proportional to the weight. Weights must sum to less than
+// 2^32; a lane whose legal actions all weigh zero checks or calls.
+using BatchPolicy = std::array<std::uint32_t, kBatchActions>;
+
+constexpr BatchPolicy kUniformBatchPolicy{1, 1, 1, 1, 1, 1};
+
+// N hands stored as structure of arrays and advanced in lock step by branch-free per-lane
+// kernels the compiler can vectorize. Lanes are grouped in blocks of kBlockLanes, each
+// block one struct of fixed-size arrays (one per State field), so the kernels see
+// non-aliasing, constant-length loops. Transitions match Rules exactly. All cards of a
+// hand are dealt when a lane is reset and revealed by street, so lanes need no deck, and
+// each lane draws its policy choices from its own stream seeded per hand.
+class StateBatch {
+public:
+    static constexpr std::size_t kBlockLanes = 64;
+
+    // `lanes` is rounded up to a whole number of blocks; every lane starts terminal.
+    explicit StateBatch(std::size_t lanes, const RulesConfig& config = RulesConfig{});
+
+    std::size_t size() const { return blocks_.size() * kBlockLanes; }
+
+    // Starts a new hand in `lane`; its deal and policy draws depend only on `seed`.
+    void reset(std::size_t lane, std::uint64_t seed);
+    // Marks the lane finished without a hand; it stays terminal until reset.
+    void retire(std::size_t lane);
+
+    bool terminal(std::size_t lane) const { return block(lane).street[slot(lane)] == kTerminal; }
+    int actions(std::size_t lane) const { return block(lane).actions[slot(lane)]; }
+    unsigned legal_mask(std::size_t lane) const { return static_cast<unsigned>(block(lane).legal[slot(lane)]); }
+    bool folded(std::size_t lane) const { return block(lane).folded[slot(lane)] != 0; }
+    // Winner of a finished lane as in TerminalResult: 0, 1, or -1 for a split pot.
+    int winner(std::size_t lane) const;
+
+    // Kernels over every lane; terminal lanes are left unchanged.
+    void compute_legal();                    // bit k of legal_mask: BatchAction k
+    void choose(const BatchPolicy& weights); // needs compute_legal()
+    void set_choice(std::size_t lane, BatchAction a) { block(lane).choice[slot(lane)] = static_cast<std::int32_t>(a); }
+    void apply();                            // needs compute_legal()
+
+    // Player 0 chip result of every lane into p0_delta[0, size()); 0 for lanes in play.
+    void payoffs(std::int32_t* p0_delta) const;
+
+    // The Rules action a batch choice stands for in `lane`'s current state.
+    Action action(std::size_t lane, BatchAction a) const;
+
+    // Snapshot of a lane as a State (no action log or deck).
+    State state(std::size_t lane) const;
+
+private:
+    static constexpr std::int32_t kTerminal = static_cast<std::int32_t>(Street::Terminal);
+
+    using Lanes = std::array<std::int32_t, kBlockLanes>;
+    using CardLanes = std::array<std::uint8_t, kBlockLanes>;
+
+    // Every per-lane field is 32 bits wide so each kernel is one loop of same-width
+    // lanes; the cards are only read when a lane is reset or inspected.
+    struct Block {
+        Lanes pot;
+        std::array<Lanes, 2> stack;
+        std::array<Lanes, 2> round; // committed this round
+        std::array<Lanes, 2> total; // committed this hand
+        Lanes current_bet;
+        Lanes last_bet;
+        Lanes street;
+        Lanes to_act;
+        Lanes folded;         // bit p set if player p folded
+        Lanes street_actions; // actions taken on the current street
+        Lanes raises;         // bets and raises on the current street
+        Lanes actions;
+        Lanes dealt;          // board cards revealed so far
+        Lanes legal;
+        std::array<Lanes, 3> amount; // per bet size, from compute_legal()
+        Lanes choice;
+        std::array<std::uint32_t, kBlockLanes> rng; // per-lane counter, hashed for each draw
+        Lanes showdown;                             // sign of (player 0 score - player 1 score)
+        std::array<CardLanes, 4> hole;              // p0 c0, p0 c1, p1 c0, p1 c1
+        std::array<CardLanes, 5> board;
+    };
+
+    Block& block(std::size_t lane) { return blocks_[lane / kBlockLanes]; }
+    const Block& block(std::size_t lane) const { return blocks_[lane / kBlockLanes]; }
+    static std::size_t slot(std::size_t lane) { return lane % kBlockLanes; }
+
+    RulesConfig config_;
+    std::vector<Block> blocks_;
+};
+
+} // namespace poker
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "poker/rules_core.hpp"
+#include "poker/tree.hpp"
+#include "poker/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Betting abstractions whose sizes are template arguments. Action generation then unrolls
+// into straight-line code with integer pot-fraction math: no size vectors, no doubles.
+// BettingAbstraction stays the runtime form for experimenting with sizes.
+//
+//   using Sizes = StreetSizes<SizeList<PotFraction<1, 2>, PotFraction<1>>, // preflop
+//                             SizeList<PotFraction<1, 2>, PotFraction<1>>, // flop
+//                             SizeList<PotFraction<1>>>;                   // turn, river
+//   TreeBuilder builder = make_tree_builder(StaticAbstraction<Sizes>{});
+namespace poker {
+
+// Num/Den of the pot, rounded down. Exact for every pot, unlike a double multiply, so
+// e.g. a third of a pot of 3 is 1 chip.
+template <int Num, int Den = 1>
+struct PotFraction {
+    static_assert(Num > 0 && Den > 0, "pot fractions must be positive");
+
+    static constexpr int chips(int pot) { return pot * Num / Den; }
+    static constexpr double value = static_cast<double>(Num) / Den;
+};
+
+template <typename... Fractions>
+struct SizeList {
+    static constexpr std::size_t count = sizeof...(Fractions);
+
+    template <typename F>
+    static void for_each(int pot, F& f) {
+        (f(Fractions::chips(pot)), ...);
+    }
+
+    static std::vector<double> values() { return {Fractions::value...}; }
+};
+
+// Size lists by street; a street without its own list repeats the previous one.
+template <typename Preflop, typename Flop = Preflop, typename Turn = Flop, typename River = Turn>
+struct StreetSizes {
+    static constexpr std::size_t max_count = std::max({Preflop::count, Flop::count, Turn::count, River::count});
+
+    template <typename F>
+    static void for_each(int street, int pot, F& f) {
+        switch (street) {
+            case 0:
+                Preflop::for_each(pot, f);
+                break;
+            case 1:
+                Flop::for_each(pot, f);
+                break;
+            case 2:
+                Turn::for_each(pot, f);
+                break;
+            default:
+                River::for_each(pot, f);
+                break;
+        }
+    }
+
+    static std::array<std::vector<double>, 4> values() {
+        return {Preflop::values(), Flop::values(), Turn::values(), River::values()};
+    }
+};
+
+template <typename Bets, typename Raises = Bets, int MaxRaises = 2, bool AllowAllIn = true>
+struct StaticAbstraction {
+    // Fold/check, call and all-in plus the sizes must fit one ActionBuffer.
+    static_assert(Bets::max_count + 3 <= kMaxActions && Raises::max_count + 3 <= kMaxActions,
+                  "too many bet or raise sizes on one street");
+
+    int starting_stack = 1000;
+    int small_blind = 5;
+    int big_blind = 10;
+
+    static constexpr int max_raises_per_street = MaxRaises;
+    static constexpr bool allow_all_in = AllowAllIn;
+
+    // Abstraction interface of rules_core.hpp.
+    template <typename F>
+    void for_each_size(int street, bool raise, int pot, F&& f) const {
+        if (raise) {
+            Raises::for_each(street, pot, f);
+        } else {
+            Bets::for_each(street, pot, f);
+        }
+    }
+
+    static void legal_actions(const TreeState& s, ActionBuffer& out) {
+        core::legal_actions(s, StaticAbstraction{}, out);
+    }
+
+    // The same abstraction in runtime form. Its sizes are the fractions as doubles, so
+    // fractions that are not exact in binary can round to a different chip count.
+    BettingAbstraction runtime() const {
+        BettingAbstraction ab;
+        ab.starting_stack = starting_stack;
+        ab.small_blind = small_blind;
+        ab.big_blind = big_blind;
+        ab.max_raises_per_street = max_raises_per_street;
+        ab.allow_all_in = allow_all_in;
+        ab.bet_sizes_by_street = Bets::values();
+        ab.raise_sizes_by_street = Raises::values();
+        return ab;
+    }
+};
+
+template <typename Bets, typename Raises, int MaxRaises, bool AllowAllIn>
+TreeBuilder make_tree_builder(const StaticAbstraction<Bets, Raises, MaxRaises, AllowAllIn>& ab) {
+    return TreeBuilder(ab.runtime(), &StaticAbstraction<Bets, Raises, MaxRaises, AllowAllIn>::legal_actions);
+}
+
+} // namespace poker
@@ -4,18 +4,21 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
 namespace poker {
 
-enum class NodeType {
+enum class NodeType : std::uint8_t {
     Decision,
     Chance,
     Terminal
 };
 
-enum class TerminalKind {
+enum class TerminalKind : std::uint8_t {
     Fold,
     Showdown
 };
@@ -43,6 +46,14 @@ struct BettingAbstraction {
         std::vector<double>{0.5, 1.0, 2.0},
         std::vector<double>{0.5, 1.0, 2.0}
     };
+
+    // Abstraction interface of rules_core.hpp.
+    template <typename F>
+    void for_each_size(int street, bool raise, int pot, F&& f) const {
+        for (double x : (raise ? raise_sizes_by_street : bet_sizes_by_street)[static_cast<std::size_t>(street)]) {
+            f(static_cast<int>(pot * x));
+        }
+    }
 };
 
 struct TreeState {
@@ -58,6 +69,7 @@ struct TreeState {
     std::array<bool, 2> folded{false, false};
     std::array<bool, 2> acted_this_round{false, false};
     int raises_this_street = 0;
+    std::uint64_t hash = 0; // zobrist.hpp fingerprint, kept current by the builder
 };
 
 struct TerminalData {
@@ -69,37 +81,179 @@ struct TerminalData {
     std::array<int, 2> chip_delta_if_forced{0, 0};
 };
 
+// A node of a GameTree; its id is its index in GameTree::nodes. Edges and terminal data
+// live in the tree's flat arrays.
 struct TreeNode {
-    int id = -1;
+    std::uint32_t first_child = 0; // first edge in GameTree::actions and GameTree::children
+    std::uint8_t child_count = 0;
     NodeType type = NodeType::Decision;
-    std::string key;
-    TreeState state;
+    Street street = Street::Preflop;
+    std::uint8_t player = 0;    // to act at a Decision node
+    std::int32_t to_call = 0;   // chips `player` must add to call, at a Decision node
+    std::int32_t terminal = -1; // into GameTree::terminals for Terminal nodes
+};
 
-    // For Decision nodes: actions[i] leads to children[i].
-    std::vector<Action> actions;
-    std::vector<int> children;
+static_assert(sizeof(TreeNode) == 16, "TreeNode is laid out to stay 16 bytes");
+static_assert(kMaxActions <= 255, "TreeNode::child_count is 8 bits");
 
-    // For Terminal nodes.
-    TerminalData terminal;
+// The action of a decision edge; its player, street and call amount are the parent node's
+// (see GameTree::action).
+struct TreeAction {
+    std::int32_t amount = 0;
+    ActionType type = ActionType::Check;
 };
 
+// Read-only view of a contiguous run of a tree array.
+template <typename T>
+struct Span {
+    const T* first = nullptr;
+    const T* last = nullptr;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    const T& operator[](std::size_t i) const { return first[i]; }
+};
+
+// Read-only view of a tree's arrays, owned by a GameTree or mapped from a tree file (see
+// tree_file.hpp), with GameTree's accessors.
+struct GameTreeView {
+    int root_id = -1;
+    Span<TreeNode> nodes;
+    Span<TreeAction> actions;
+    Span<std::int32_t> children;
+    Span<TerminalData> terminals;
+
+    Span<TreeAction> actions_of(const TreeNode& n) const {
+        return {actions.begin() + n.first_child, actions.begin() + n.first_child + n.child_count};
+    }
+    Span<std::int32_t> children_of(const TreeNode& n) const {
+        return {children.begin() + n.first_child, children.begin() + n.first_child + n.child_count};
+    }
+    const TerminalData& terminal_of(const TreeNode& n) const {
+        return terminals[static_cast<std::size_t>(n.terminal)];
+    }
+    Action action(const TreeNode& n, std::size_t i) const {
+        const TreeAction& a = actions[n.first_child + i];
+        return Action{n.player, a.type, a.amount, n.to_call, n.street};
+    }
+};
+
+// Compressed sparse row layout: the edges of each node are contiguous, so node n's i-th
+// edge is actions[n.first_child + i] and leads to children[n.first_child + i]. A Chance
+// node has one edge (the next street's cards) with a default TreeAction.
 struct GameTree {
     int root_id = -1;
     std::vector<TreeNode> nodes;
+    std::vector<TreeAction> actions;
+    std::vector<std::int32_t> children;
+    std::vector<TerminalData> terminals;
+
+    // Optional side table by node id, filled when the build keeps states.
+    std::vector<TreeState> states;
+
+    Span<TreeAction> actions_of(const TreeNode& n) const {
+        return {actions.data() + n.first_child, actions.data() + n.first_child + n.child_count};
+    }
+    Span<std::int32_t> children_of(const TreeNode& n) const {
+        return {children.data() + n.first_child, children.data() + n.first_child + n.child_count};
+    }
+    const TerminalData& terminal_of(const TreeNode& n) const {
+        return terminals[static_cast<std::size_t>(n.terminal)];
+    }
+
+    // The full Action of decision node n's i-th edge.
+    Action action(const TreeNode& n, std::size_t i) const {
+        const TreeAction& a = actions[n.first_child + i];
+        return Action{n.player, a.type, a.amount, n.to_call, n.street};
+    }
+
+    GameTreeView view() const {
+        return GameTreeView{root_id,
+                            {nodes.data(), nodes.data() + nodes.size()},
+                            {actions.data(), actions.data() + actions.size()},
+                            {children.data(), children.data() + children.size()},
+                            {terminals.data(), terminals.data() + terminals.size()}};
+    }
+};
+
+struct TreeBuildProgress {
+    std::size_t nodes = 0;
+    std::size_t edges = 0;
+    std::size_t open_nodes = 0; // reached nodes whose edges are still being expanded
+};
+
+using TreeProgressCallback = std::function<void(const TreeBuildProgress& progress)>;
+
+struct TreeBuildOptions {
+    std::size_t max_nodes = 200000;
+    // Fill GameTree::states, e.g. for debug_key.
+    bool keep_states = false;
+    // Called every progress_interval nodes (never if 0) and when the build finishes. A
+    // parallel build calls it from its workers, one call at a time, with counts that may
+    // lag by a few thousand nodes; its open_nodes counts pending chance subtrees.
+    TreeProgressCallback progress;
+    std::size_t progress_interval = 1000000;
+    // Workers expanding chance subtrees in parallel; 0 = hardware concurrency, 1 builds on
+    // the calling thread. The tree is identical for any thread count.
+    int threads = 1;
+};
+
+// Node ids are int32 throughout (GameTree::children, TreeNode::terminal), which bounds the
+// size of any tree.
+constexpr std::size_t kMaxTreeNodes = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+// Size of the tree an abstraction builds, counted without building it.
+struct TreeEstimate {
+    // Node counts by TreeNode::street (terminal nodes are all under Street::Terminal) and
+    // NodeType.
+    std::array<std::array<std::size_t, 3>, 6> nodes{};
+    std::size_t edges = 0;
+    std::size_t decision_edges = 0;
+    // Set when the tree has more nodes than the estimate's limit; the counts then cover only
+    // the nodes walked before it stopped.
+    bool over_limit = false;
+
+    std::size_t count(NodeType type) const;
+    std::size_t total_nodes() const;
+    // Bytes of the GameTree arrays, without the optional states.
+    std::size_t tree_bytes() const;
+    // Bytes of a CFR solver's float regrets and strategy sums: one of each per decision edge
+    // and hand of the acting player's range of `range_size` hands.
+    std::size_t solver_bytes(std::size_t range_size) const;
+    std::size_t total_bytes(std::size_t range_size) const { return tree_bytes() + solver_bytes(range_size); }
 };
 
 class TreeBuilder {
 public:
+    // Fills the legal actions of a decision state in place of the runtime size lists (see
+    // StaticAbstraction in static_abstraction.hpp).
+    using ActionGenerator = void (*)(const TreeState& s, ActionBuffer& out);
+
     explicit TreeBuilder(BettingAbstraction abstraction);
+    // `abstraction` supplies the stacks and blinds, `generate` the actions.
+    TreeBuilder(BettingAbstraction abstraction, ActionGenerator generate);
 
     GameTree build(std::size_t max_nodes = 200000) const;
+    GameTree build(const TreeBuildOptions& options) const;
+
+    // Walks the tree this builder would build, keeping only its dedup table: no nodes,
+    // edges or terminals are stored. The walk stops with over_limit set as soon as it finds
+    // more than `max_nodes` nodes (at most kMaxTreeNodes, as node ids are 32-bit).
+    TreeEstimate estimate(std::size_t max_nodes = kMaxTreeNodes) const;
+    static TreeEstimate estimate(const BettingAbstraction& abstraction, std::size_t max_nodes = kMaxTreeNodes);
 
     static BettingAbstraction default_abstraction();
 
 private:
     BettingAbstraction abstraction_;
+    ActionGenerator generate_ = nullptr;
 };
 
+// Readable identity of node `id` ("D:", "C:", "T:F:" or "T:S:" and the state's fields),
+// formatted on demand; the builder dedups on a binary key instead. Needs tree.states.
+std::string debug_key(const GameTree& tree, int id);
+
 std::string to_string(NodeType t);
 std::string to_string(TerminalKind t);
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "poker/mapped_file.hpp"
+#include "poker/tree.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace poker {
+
+// On-disk layout: this header, then the GameTree arrays as they are laid out in memory:
+// num_nodes TreeNodes, num_edges TreeActions, num_edges int32 children and num_terminals
+// TerminalData, each array padded with zeros to a multiple of 8 bytes. Everything is in
+// the writer's byte order, which byte_order records; the record sizes are stored too, so a
+// file from a different byte order or layout is rejected. The optional per-node states are
+// not saved.
+struct TreeFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::int32_t root_id;
+    std::uint32_t node_bytes;
+    std::uint32_t action_bytes;
+    std::uint32_t terminal_bytes;
+    std::uint32_t byte_order; // kTreeFileByteOrder as written
+    std::uint64_t num_nodes;
+    std::uint64_t num_edges;
+    std::uint64_t num_terminals;
+    std::uint64_t checksum; // FNV-1a over the 64-bit words of everything after the header
+};
+
+constexpr std::uint32_t kTreeFileVersion = 2;
+constexpr std::uint32_t kTreeFileByteOrder = 0x01020304;
+
+// Writes a tree file; throws std::runtime_error on I/O failure.
+void write_game_tree(const std::string& path, const GameTree& tree);
+
+// A GameTree mapped read-only from a tree file. Opening costs a page-table setup rather
+// than a copy, and processes mapping the same file share its pages.
+class MappedGameTree {
+public:
+    MappedGameTree() = default;
+
+    // Maps and validates the file: magic, version, byte order, record sizes, size, and that
+    // every node's type, edges, children and terminal index are in range, so walking the
+    // view never reads outside the mapping. Unless `verify_checksum` is false the checksum
+    // is checked as well; it hashes the whole file, so skip it only for a file known to be
+    // intact. Throws std::runtime_error on any mismatch.
+    static MappedGameTree open(const std::string& path, bool verify_checksum = true);
+
+    bool loaded() const { return file_.is_open(); }
+    const TreeFileHeader& header() const;
+    const GameTreeView& tree() const { return view_; }
+
+private:
+    MappedFile file_;
+    GameTreeView view_;
+};
+
+} // namespace poker
@@ -1,12 +1,18 @@
 #pragma once
 
+#include "poker/card_set.hpp"
+#include "poker/deck.hpp"
+#include "poker/fixed_vector.hpp"
+
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <vector>
+#include <type_traits>
 
 namespace poker {
 
-enum class Street {
+enum class Street : std::uint8_t {
     Preflop,
     Flop,
     Turn,
@@ -15,7 +21,7 @@ enum class Street {
     Terminal
 };
 
-enum class ActionType {
+enum class ActionType : std::uint8_t {
     Fold,
     Check,
     Call,
@@ -31,6 +37,48 @@ struct Action {
     Street street = Street::Preflop;
 };
 
+// Upper bound on the legal actions at one decision: fold, call, the configured sizes and
+// all-in.
+constexpr std::size_t kMaxActions = 16;
+
+// Legal actions of one decision in canonical order (by type, then amount, no duplicates),
+// stored inline so generating them never allocates.
+class ActionBuffer : public FixedVector<Action, kMaxActions> {
+public:
+    // Inserts `a` at its canonical position unless an action with the same type and amount
+    // is already present. Generators emit in nearly sorted order, so this is usually a single
+    // comparison with the last element.
+    void add(const Action& a) {
+        std::size_t i = size();
+        while (i > 0 && precedes(a, (*this)[i - 1])) {
+            --i;
+        }
+        if (i > 0 && same(a, (*this)[i - 1])) {
+            return;
+        }
+        push_back(a);
+        for (std::size_t j = size() - 1; j > i; --j) {
+            (*this)[j] = (*this)[j - 1];
+        }
+        (*this)[i] = a;
+    }
+
+private:
+    static bool precedes(const Action& a, const Action& b) {
+        return a.type != b.type ? a.type < b.type : a.amount < b.amount;
+    }
+    static bool same(const Action& a, const Action& b) { return a.type == b.type && a.amount == b.amount; }
+};
+
+// Longest action sequence a State can record. Rules refuses bet sizes, raise caps, stacks
+// and blinds under which a hand could take more actions (see max_hand_actions); with bets
+// of at least half the pot and no raise cap, stacks of 100,000 big blinds fit.
+constexpr std::size_t kMaxHistory = 64;
+
+using Board = FixedVector<int, 5>;
+using ActionLog = FixedVector<Action, kMaxHistory>;
+
+// Plain data with inline board and action log: copies are a memcpy and never allocate.
 struct State {
     Street street = Street::Preflop;
     int pot = 0;
@@ -42,13 +90,19 @@ struct State {
     std::array<int, 2> committed_this_round{0, 0};
     std::array<int, 2> committed_total{0, 0};
     std::array<bool, 2> folded{false, false};
-    std::vector<Action> history;
+    std::array<bool, 2> acted_this_round{false, false};
+    int raises_this_street = 0;
+    std::uint64_t hash = 0; // zobrist.hpp fingerprint, kept current by Rules
+    ActionLog history;
 
     std::array<std::array<int, 2>, 2> hole_cards{};
-    std::vector<int> board;
-    std::array<bool, 52> used_cards{};
+    Board board;
+    CardSet used_cards; // hole and board cards dealt so far
+    Deck deck;          // undealt cards for the rest of the hand
 };
 
+static_assert(std::is_trivially_copyable<State>::value, "State must stay memcpy-copyable");
+
 struct TerminalResult {
     bool is_terminal = false;
     int winner = -1;
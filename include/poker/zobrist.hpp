@@ -0,0 +1,99 @@
+#pragma once
+
+#include "poker/rng.hpp"
+#include "poker/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Zobrist-style 64-bit state fingerprints. Every (field, value) pair has a pseudo-random
+// key and a state's hash is the sum (mod 2^64) of the keys of its field values, so an
+// action updates the hash by subtracting the old key of each field it changes and adding
+// the new one. rules_core.hpp keeps State::hash and TreeState::hash current this way and
+// Rules adds the cards it deals; the functions below compute it from scratch.
+//
+// The hash covers the betting fields and the cards, not the action history or deck order:
+// transpositions hash alike. The pot (the sum of the totals committed) and bet_to_call
+// (current_bet less the commitment of the player to act) follow from the other fields and
+// are left out. Chip keys are linear in the chip count, which leaves the low bits less
+// mixed than the high ones: index tables by the high bits.
+namespace poker::zobrist {
+
+enum Field : std::uint32_t {
+    // Fields with few values come first; their keys are tabulated.
+    StreetNumber,
+    ToAct,
+    Folded,    // + player
+    Acted = Folded + 2,
+    Raises = Acted + 2,
+    Hole,      // + player; a set, so card order does not matter
+    BoardCard = Hole + 2,
+    Stack,
+    LastBetSize = Stack + 2,
+    CurrentBet,
+    Round,     // committed this round, + player
+    Total = Round + 2
+};
+
+constexpr std::uint64_t mix_key(std::uint32_t field, int value) {
+    return split_mix64((static_cast<std::uint64_t>(field) << 32) | static_cast<std::uint32_t>(value));
+}
+
+constexpr std::uint32_t kTabulatedFields = Stack;
+constexpr std::uint32_t kTabulatedValues = 64;
+
+constexpr std::array<std::uint64_t, kTabulatedFields * kTabulatedValues> make_key_table() {
+    std::array<std::uint64_t, kTabulatedFields * kTabulatedValues> t{};
+    for (std::uint32_t f = 0; f < kTabulatedFields; ++f) {
+        for (std::uint32_t v = 0; v < kTabulatedValues; ++v) {
+            t[f * kTabulatedValues + v] = mix_key(f, static_cast<int>(v));
+        }
+    }
+    return t;
+}
+
+inline constexpr auto kKeyTable = make_key_table();
+
+// Key of a field value: a table load for flags, counters and cards; for chip counts the
+// value times a random odd multiplier of the field, so that a change of d chips moves the
+// hash by d multipliers at the cost of one multiply.
+inline std::uint64_t key(std::uint32_t field, int value) {
+    if (field < kTabulatedFields && static_cast<std::uint32_t>(value) < kTabulatedValues) {
+        return kKeyTable[field * kTabulatedValues + static_cast<std::uint32_t>(value)];
+    }
+    if (field < kTabulatedFields) {
+        return mix_key(field, value);
+    }
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) * (mix_key(field, 0) | 1);
+}
+
+inline std::uint64_t key(std::uint32_t field, std::size_t player, int value) {
+    return key(field + static_cast<std::uint32_t>(player), value);
+}
+
+template <typename S>
+std::uint64_t betting_hash(const S& s) {
+    std::uint64_t h = key(StreetNumber, static_cast<int>(s.street)) + key(ToAct, s.to_act) +
+                      key(LastBetSize, s.last_bet_size) + key(CurrentBet, s.current_bet) +
+                      key(Raises, s.raises_this_street);
+    for (std::size_t p = 0; p < 2; ++p) {
+        h += key(Stack, p, s.stacks[p]) + key(Round, p, s.committed_this_round[p]) +
+             key(Total, p, s.committed_total[p]) + key(Folded, p, s.folded[p]) +
+             key(Acted, p, s.acted_this_round[p]);
+    }
+    return h;
+}
+
+inline std::uint64_t hash(const State& s) {
+    std::uint64_t h = betting_hash(s);
+    for (std::size_t p = 0; p < 2; ++p) {
+        h += key(Hole, p, s.hole_cards[p][0]) + key(Hole, p, s.hole_cards[p][1]);
+    }
+    for (int c : s.board) {
+        h += key(BoardCard, c);
+    }
+    return h;
+}
+
+} // namespace poker::zobrist
@@ -1,4 +1,5 @@
 #include "poker/engine.hpp"
+#include "poker/preflop_table.hpp"
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -301,9 +302,25 @@ int parse_index_field(const std::string& body) {
 
 } // namespace
 
-int main() {
+int main(int argc, char** argv) {
     std::signal(SIGINT, on_sigint);
 
+    std::optional<poker::PreflopEquityTable> preflop_table;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--preflop-table" && i + 1 < argc) {
+            try {
+                preflop_table = poker::PreflopEquityTable::open(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "usage: poker_api_server [--preflop-table PATH]\n";
+            return 1;
+        }
+    }
+
     poker::Engine engine(1337);
     std::optional<poker::State> state = engine.new_hand();
 
@@ -369,7 +386,8 @@ int main() {
         } else if (req.method == "GET" && req.path == "/state") {
             send_json_response(client_fd, 200, state_to_json(*state));
         } else if (req.method == "GET" && req.path == "/legal_actions") {
-            const auto legals = engine.legal_actions(*state);
+            poker::ActionBuffer legals;
+            engine.legal_actions(*state, legals);
             std::ostringstream os;
             os << "[";
             for (std::size_t i = 0; i < legals.size(); ++i) {
@@ -382,7 +400,8 @@ int main() {
             send_json_response(client_fd, 200, os.str());
         } else if (req.method == "POST" && req.path == "/apply_action") {
             const int index = parse_index_field(req.body);
-            const auto legals = engine.legal_actions(*state);
+            poker::ActionBuffer legals;
+            engine.legal_actions(*state, legals);
             if (index < 0 || index >= static_cast<int>(legals.size())) {
                 send_json_response(client_fd, 400, "{\"ok\":false,\"error\":\"invalid index\"}");
             } else {
@@ -390,7 +409,8 @@ int main() {
                 send_json_response(client_fd, 200, std::string("{\"ok\":") + (ok ? "true" : "false") + "}");
             }
         } else if (req.method == "POST" && req.path == "/apply_random_action") {
-            const auto legals = engine.legal_actions(*state);
+            poker::ActionBuffer legals;
+            engine.legal_actions(*state, legals);
             if (legals.empty()) {
                 send_json_response(client_fd, 400, "{\"ok\":false,\"error\":\"no legal actions\"}");
             } else {
@@ -400,6 +420,19 @@ int main() {
             }
         } else if (req.method == "GET" && req.path == "/terminal_result") {
             send_json_response(client_fd, 200, terminal_to_json(engine.terminal_payoff(*state)));
+        } else if (req.method == "GET" && req.path == "/preflop_equity") {
+            if (!preflop_table) {
+                send_json_response(client_fd, 404, "{\"error\":\"preflop table not loaded\"}");
+            } else {
+                const int c0 = poker::preflop_class(state->hole_cards[0]);
+                const int c1 = poker::preflop_class(state->hole_cards[1]);
+                std::ostringstream os;
+                os << "{";
+                os << "\"classes\":[\"" << poker::preflop_class_name(c0) << "\",\"" << poker::preflop_class_name(c1) << "\"],";
+                os << "\"equity\":[" << preflop_table->equity(c0, c1) << "," << preflop_table->equity(c1, c0) << "]";
+                os << "}";
+                send_json_response(client_fd, 200, os.str());
+            }
         } else if (req.method == "GET" && req.path == "/health") {
             send_json_response(client_fd, 200, "{\"ok\":true}");
         } else {
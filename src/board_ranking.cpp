@@ -0,0 +1,174 @@
+#include "poker/board_ranking.hpp"
+
+#include "poker/cards.hpp"
+#include "poker/hand_eval.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace poker {
+
+namespace {
+
+const std::vector<std::array<int, 2>>& all_combos() {
+    static const std::vector<std::array<int, 2>> combos = [] {
+        std::vector<std::array<int, 2>> out;
+        out.reserve(kNumCombos);
+        for (int i = 0; i < kNumCombos; ++i) {
+            out.push_back(combo_cards(i));
+        }
+        return out;
+    }();
+    return combos;
+}
+
+} // namespace
+
+BoardRanking::BoardRanking(const std::array<int, 5>& board) : board_(board), board_cards_(CardSet::from(board)) {
+    evaluate_board_batch(board_, all_combos(), scores_);
+
+    hands_.reserve(kNumCombos);
+    for (int i = 0; i < kNumCombos; ++i) {
+        const int s = scores_[static_cast<std::size_t>(i)];
+        if (s >= 0) {
+            hands_.push_back(RankedCombo{i, s});
+        }
+    }
+    std::sort(hands_.begin(), hands_.end(), [](const RankedCombo& a, const RankedCombo& b) {
+        if (a.score != b.score) return a.score < b.score;
+        return a.combo < b.combo;
+    });
+
+    for (std::size_t i = 0; i < hands_.size(); ++i) {
+        if (i == 0 || hands_[i].score != hands_[i - 1].score) {
+            group_offsets_.push_back(static_cast<int>(i));
+        }
+    }
+    group_offsets_.push_back(static_cast<int>(hands_.size()));
+}
+
+void BoardRanking::showdown_values(const double* opp_reach, const ShowdownPayoffs& payoffs, double* out) const {
+    std::fill(out, out + kNumCombos, 0.0);
+
+    // Opponent reach strictly weaker (first pass) or strictly stronger (second pass) than the
+    // current group, in total and per card. Removing the per-card sums of our two cards drops
+    // every opponent combo that shares a card with us; only our own combo shares both, and it
+    // is never in a strictly weaker or stronger set, so no double counting occurs.
+    std::array<double, 52> by_card{};
+    double total = 0.0;
+
+    const int groups = num_groups();
+    for (int g = 0; g < groups; ++g) {
+        const int begin = group_offsets_[static_cast<std::size_t>(g)];
+        const int end = group_offsets_[static_cast<std::size_t>(g) + 1];
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double beaten = total - by_card[static_cast<std::size_t>(cards[0])] - by_card[static_cast<std::size_t>(cards[1])];
+            out[combo] += payoffs.win * beaten;
+        }
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double r = opp_reach[combo];
+            total += r;
+            by_card[static_cast<std::size_t>(cards[0])] += r;
+            by_card[static_cast<std::size_t>(cards[1])] += r;
+        }
+    }
+
+    by_card.fill(0.0);
+    total = 0.0;
+    for (int g = groups - 1; g >= 0; --g) {
+        const int begin = group_offsets_[static_cast<std::size_t>(g)];
+        const int end = group_offsets_[static_cast<std::size_t>(g) + 1];
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double beating = total - by_card[static_cast<std::size_t>(cards[0])] - by_card[static_cast<std::size_t>(cards[1])];
+            out[combo] += payoffs.lose * beating;
+        }
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double r = opp_reach[combo];
+            total += r;
+            by_card[static_cast<std::size_t>(cards[0])] += r;
+            by_card[static_cast<std::size_t>(cards[1])] += r;
+        }
+    }
+
+    if (payoffs.tie == 0.0) {
+        return;
+    }
+
+    // Ties: inclusion-exclusion within the group; our own combo is counted in both card sums.
+    std::array<double, 52> group_by_card{};
+    for (int g = 0; g < groups; ++g) {
+        const int begin = group_offsets_[static_cast<std::size_t>(g)];
+        const int end = group_offsets_[static_cast<std::size_t>(g) + 1];
+        double group_total = 0.0;
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double r = opp_reach[combo];
+            group_total += r;
+            group_by_card[static_cast<std::size_t>(cards[0])] += r;
+            group_by_card[static_cast<std::size_t>(cards[1])] += r;
+        }
+        for (int i = begin; i < end; ++i) {
+            const int combo = hands_[static_cast<std::size_t>(i)].combo;
+            const auto& cards = combo_cards(combo);
+            const double tied = group_total - group_by_card[static_cast<std::size_t>(cards[0])] -
+                                group_by_card[static_cast<std::size_t>(cards[1])] + opp_reach[combo];
+            out[combo] += payoffs.tie * tied;
+        }
+        for (int i = begin; i < end; ++i) {
+            const auto& cards = combo_cards(hands_[static_cast<std::size_t>(i)].combo);
+            group_by_card[static_cast<std::size_t>(cards[0])] = 0.0;
+            group_by_card[static_cast<std::size_t>(cards[1])] = 0.0;
+        }
+    }
+}
+
+void BoardRanking::showdown_values(const std::vector<double>& opp_reach, const ShowdownPayoffs& payoffs, std::vector<double>& out) const {
+    out.resize(kNumCombos);
+    showdown_values(opp_reach.data(), payoffs, out.data());
+}
+
+std::shared_ptr<const BoardRanking> BoardRankingCache::get(const std::array<int, 5>& board) {
+    const std::uint64_t key = CardSet::from(board).mask();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = rankings_.find(key);
+        if (it != rankings_.end()) {
+            return it->second;
+        }
+    }
+
+    // Build outside the lock; if another thread won the race, keep its ranking.
+    auto ranking = std::make_shared<const BoardRanking>(board);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rankings_.emplace(key, std::move(ranking)).first->second;
+}
+
+CanonicalRanking BoardRankingCache::get_canonical(const std::array<int, 5>& board) {
+    const CanonicalBoard canonical = canonicalize_board({board.begin(), board.end()});
+    CanonicalRanking out;
+    out.ranking = get({canonical.cards[0], canonical.cards[1], canonical.cards[2], canonical.cards[3], canonical.cards[4]});
+    out.perm = canonical.perm;
+    return out;
+}
+
+std::size_t BoardRankingCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rankings_.size();
+}
+
+void BoardRankingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rankings_.clear();
+}
+
+} // namespace poker
@@ -0,0 +1,406 @@
+#include "poker/equity.hpp"
+
+#include "poker/cards.hpp"
+#include "poker/hand_eval.hpp"
+#include "poker/rng.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace poker {
+
+namespace {
+
+constexpr std::uint64_t kSamplesPerChunk = 4096;
+
+std::uint64_t binomial(int n, int k) {
+    if (k < 0 || k > n) {
+        return 0;
+    }
+    std::uint64_t r = 1;
+    for (int i = 1; i <= k; ++i) {
+        r = r * static_cast<std::uint64_t>(n - k + i) / static_cast<std::uint64_t>(i);
+    }
+    return r;
+}
+
+int resolve_threads(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<int>(hw);
+}
+
+// Runs f(unit) for every unit in [0, units) on `threads` workers pulling from a shared counter.
+template <typename F>
+void parallel_for(int threads, std::size_t units, const F& f) {
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&]() {
+        for (std::size_t u = next.fetch_add(1); u < units; u = next.fetch_add(1)) {
+            f(u);
+        }
+    };
+    const int spawn = static_cast<int>(std::min<std::size_t>(static_cast<std::size_t>(threads), units)) - 1;
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<std::size_t>(std::max(0, spawn)));
+    for (int t = 0; t < spawn; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+}
+
+struct Tally {
+    std::uint64_t wins = 0;
+    std::uint64_t ties = 0;
+};
+
+struct Holding {
+    HandAccumulator acc; // hole cards plus board
+    CardSet cards;       // hole cards only
+    double weight = 0.0;
+};
+
+struct Matchup {
+    const Holding* hero = nullptr;
+    const Holding* villain = nullptr;
+    double weight = 0.0;
+};
+
+struct Problem {
+    std::vector<int> board;
+    CardSet board_cards;
+    int runout_cards = 0;
+    std::vector<Holding> hero;
+    std::vector<Holding> villain;
+    std::uint64_t num_matchups = 0;
+    double total_weight = 0.0;
+};
+
+void check_card(int c) {
+    if (c < 0 || c >= kNumCards) {
+        throw std::invalid_argument("card out of range 0..51");
+    }
+}
+
+std::vector<Holding> prepare_range(const HandRange& range, const std::vector<int>& board, CardSet board_cards) {
+    std::vector<Holding> out;
+    out.reserve(range.size());
+    for (const auto& e : range) {
+        check_card(e.cards[0]);
+        check_card(e.cards[1]);
+        const CardSet hole = CardSet::of(e.cards);
+        if (e.cards[0] == e.cards[1] || hole.intersects(board_cards) || e.weight <= 0.0) {
+            continue;
+        }
+        out.push_back(Holding{HandAccumulator(e.cards, board), hole, e.weight});
+    }
+    return out;
+}
+
+Problem prepare(const HandRange& hero, const HandRange& villain, const std::vector<int>& board) {
+    Problem p;
+    if (board.size() > 5 || board.size() == 1 || board.size() == 2) {
+        throw std::invalid_argument("board must have 0, 3, 4 or 5 cards");
+    }
+    for (int c : board) {
+        check_card(c);
+        if (p.board_cards.contains(c)) {
+            throw std::invalid_argument("duplicate board card");
+        }
+        p.board_cards.insert(c);
+    }
+    p.board = board;
+    p.runout_cards = 5 - static_cast<int>(board.size());
+    p.hero = prepare_range(hero, board, p.board_cards);
+    p.villain = prepare_range(villain, board, p.board_cards);
+
+    for (const auto& h : p.hero) {
+        for (const auto& v : p.villain) {
+            if (!h.cards.intersects(v.cards)) {
+                ++p.num_matchups;
+                p.total_weight += h.weight * v.weight;
+            }
+        }
+    }
+    if (p.num_matchups == 0) {
+        throw std::invalid_argument("no card-compatible matchup between hero and villain");
+    }
+    return p;
+}
+
+void enumerate_runouts(const HandAccumulator& hero, const HandAccumulator& villain,
+                       const int* deck, int deck_size, int k, Tally& t) {
+    if (k == 0) {
+        const int sh = hero.score();
+        const int sv = villain.score();
+        t.wins += sh > sv;
+        t.ties += sh == sv;
+        return;
+    }
+    if (k == 1) {
+        for (int i = 0; i < deck_size; ++i) {
+            const int sh = hero.score_with(deck[i]);
+            const int sv = villain.score_with(deck[i]);
+            t.wins += sh > sv;
+            t.ties += sh == sv;
+        }
+        return;
+    }
+    for (int i = 0; i + k <= deck_size; ++i) {
+        enumerate_runouts(hero.with(deck[i]), villain.with(deck[i]), deck + i + 1, deck_size - i - 1, k - 1, t);
+    }
+}
+
+EquityResult solve_exact(const Problem& p, int threads) {
+    std::vector<Matchup> matchups;
+    matchups.reserve(static_cast<std::size_t>(p.num_matchups));
+    for (const auto& h : p.hero) {
+        for (const auto& v : p.villain) {
+            if (!h.cards.intersects(v.cards)) {
+                matchups.push_back(Matchup{&h, &v, h.weight * v.weight});
+            }
+        }
+    }
+
+    const int deck_size = kNumCards - 4 - static_cast<int>(p.board.size());
+    const std::uint64_t runouts = binomial(deck_size, p.runout_cards);
+
+    // Split single matchups by their first runout card so small problems still parallelize.
+    const int splits = (p.runout_cards >= 2 && matchups.size() < static_cast<std::size_t>(threads) * 4)
+                           ? deck_size - p.runout_cards + 1
+                           : 1;
+    const std::size_t units = matchups.size() * static_cast<std::size_t>(splits);
+    std::vector<Tally> tallies(units);
+
+    parallel_for(threads, units, [&](std::size_t u) {
+        const Matchup& m = matchups[u / static_cast<std::size_t>(splits)];
+        const CardSet live = (m.hero->cards | m.villain->cards | p.board_cards).complement();
+        std::array<int, kNumCards> deck{};
+        int n = 0;
+        for (int c : live) {
+            deck[static_cast<std::size_t>(n++)] = c;
+        }
+        Tally& t = tallies[u];
+        if (splits == 1) {
+            enumerate_runouts(m.hero->acc, m.villain->acc, deck.data(), n, p.runout_cards, t);
+        } else {
+            const int i = static_cast<int>(u % static_cast<std::size_t>(splits));
+            const int first = deck[static_cast<std::size_t>(i)];
+            enumerate_runouts(m.hero->acc.with(first), m.villain->acc.with(first), deck.data() + i + 1, n - i - 1,
+                              p.runout_cards - 1, t);
+        }
+    });
+
+    // Sum in unit order so the result does not depend on scheduling.
+    EquityResult r;
+    r.exact = true;
+    double win = 0.0;
+    double tie = 0.0;
+    for (std::size_t mi = 0; mi < matchups.size(); ++mi) {
+        Tally t;
+        for (int s = 0; s < splits; ++s) {
+            const Tally& part = tallies[mi * static_cast<std::size_t>(splits) + static_cast<std::size_t>(s)];
+            t.wins += part.wins;
+            t.ties += part.ties;
+        }
+        const double w = matchups[mi].weight / p.total_weight;
+        win += w * static_cast<double>(t.wins) / static_cast<double>(runouts);
+        tie += w * static_cast<double>(t.ties) / static_cast<double>(runouts);
+    }
+    r.win = win;
+    r.tie = tie;
+    r.equity = win + tie / 2.0;
+    r.showdowns = runouts * matchups.size();
+    return r;
+}
+
+struct ChunkSums {
+    std::uint64_t samples = 0;
+    std::uint64_t wins = 0;
+    std::uint64_t ties = 0;
+};
+
+struct Sampler {
+    const std::vector<Holding>& holdings;
+    std::vector<double> cdf;
+
+    explicit Sampler(const std::vector<Holding>& h) : holdings(h) {
+        cdf.reserve(h.size());
+        double acc = 0.0;
+        for (const auto& x : h) {
+            acc += x.weight;
+            cdf.push_back(acc);
+        }
+    }
+
+    template <typename Rng>
+    const Holding& sample(Rng& rng) const {
+        if (holdings.size() == 1) {
+            return holdings[0];
+        }
+        const auto it = std::upper_bound(cdf.begin(), cdf.end(), uniform_unit(rng) * cdf.back());
+        const std::size_t i = std::min(static_cast<std::size_t>(it - cdf.begin()), holdings.size() - 1);
+        return holdings[i];
+    }
+};
+
+ChunkSums run_chunk(const Problem& p, const Sampler& hero_sampler, const Sampler& villain_sampler, std::uint64_t seed) {
+    Xoshiro256StarStar rng(seed);
+
+    ChunkSums s;
+    for (std::uint64_t i = 0; i < kSamplesPerChunk; ++i) {
+        // Rejecting card conflicts makes matchup probability proportional to the weight product.
+        const Holding* h = &hero_sampler.sample(rng);
+        const Holding* v = &villain_sampler.sample(rng);
+        while (h->cards.intersects(v->cards)) {
+            h = &hero_sampler.sample(rng);
+            v = &villain_sampler.sample(rng);
+        }
+
+        HandAccumulator hero = h->acc;
+        HandAccumulator villain = v->acc;
+        CardSet dead = h->cards | v->cards | p.board_cards;
+        for (int k = 0; k < p.runout_cards; ++k) {
+            int c = static_cast<int>(uniform_below(rng, kNumCards));
+            while (dead.contains(c)) {
+                c = static_cast<int>(uniform_below(rng, kNumCards));
+            }
+            dead.insert(c);
+            hero.add(c);
+            villain.add(c);
+        }
+
+        const int sh = hero.score();
+        const int sv = villain.score();
+        s.wins += sh > sv;
+        s.ties += sh == sv;
+        ++s.samples;
+    }
+    return s;
+}
+
+// Folds finished chunks into the total strictly in chunk order and decides after each one
+// whether to stop, so the stopping point and the result are the same for any thread count.
+class ChunkMerger {
+public:
+    ChunkMerger(std::uint64_t max_chunks, double target_std_error)
+        : max_chunks_(max_chunks), target_std_error_(target_std_error) {}
+
+    bool done() const { return done_.load(std::memory_order_relaxed); }
+
+    void add(std::uint64_t chunk, const ChunkSums& sums) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.emplace(chunk, sums);
+        for (auto it = pending_.find(merged_); !done() && it != pending_.end(); it = pending_.find(merged_)) {
+            total_.samples += it->second.samples;
+            total_.wins += it->second.wins;
+            total_.ties += it->second.ties;
+            pending_.erase(it);
+            ++merged_;
+            std_error_ = std_error(total_);
+            if (merged_ == max_chunks_ || std_error_ <= target_std_error_) {
+                done_.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const ChunkSums& total() const { return total_; }
+    double std_error() const { return std_error_; }
+
+private:
+    // Per-sample outcome is 1, 1/2 or 0.
+    static double std_error(const ChunkSums& t) {
+        const double n = static_cast<double>(t.samples);
+        const double mean = (static_cast<double>(t.wins) + 0.5 * static_cast<double>(t.ties)) / n;
+        const double mean_sq = (static_cast<double>(t.wins) + 0.25 * static_cast<double>(t.ties)) / n;
+        return std::sqrt(std::max(0.0, mean_sq - mean * mean) / n);
+    }
+
+    const std::uint64_t max_chunks_;
+    const double target_std_error_;
+    std::mutex mutex_;
+    std::map<std::uint64_t, ChunkSums> pending_; // finished ahead of the merged prefix
+    std::uint64_t merged_ = 0;
+    ChunkSums total_;
+    double std_error_ = 0.0;
+    std::atomic<bool> done_{false};
+};
+
+EquityResult solve_monte_carlo(const Problem& p, int threads, const EquityOptions& options) {
+    // The chunk index alone seeds each chunk, so results are the same for any thread count.
+    const Sampler hero_sampler(p.hero);
+    const Sampler villain_sampler(p.villain);
+
+    // One set of workers claims chunks until the merged prefix meets the target; chunks
+    // claimed past the stopping point are discarded.
+    const std::uint64_t max_samples = std::max<std::uint64_t>(options.max_samples, kSamplesPerChunk);
+    const std::uint64_t max_chunks = (max_samples + kSamplesPerChunk - 1) / kSamplesPerChunk;
+    ChunkMerger merger(max_chunks, options.target_std_error);
+    std::atomic<std::uint64_t> next_chunk{0};
+    const auto worker = [&]() {
+        while (!merger.done()) {
+            const std::uint64_t chunk = next_chunk.fetch_add(1);
+            if (chunk >= max_chunks) {
+                break;
+            }
+            merger.add(chunk, run_chunk(p, hero_sampler, villain_sampler, split_mix64(options.seed ^ split_mix64(chunk))));
+        }
+    };
+    const int spawn = static_cast<int>(std::min<std::uint64_t>(static_cast<std::uint64_t>(threads), max_chunks)) - 1;
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<std::size_t>(std::max(0, spawn)));
+    for (int t = 0; t < spawn; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    const ChunkSums& total = merger.total();
+    EquityResult r;
+    const double n = static_cast<double>(total.samples);
+    r.win = static_cast<double>(total.wins) / n;
+    r.tie = static_cast<double>(total.ties) / n;
+    r.equity = r.win + r.tie / 2.0;
+    r.std_error = merger.std_error();
+    r.showdowns = total.samples;
+    r.exact = false;
+    return r;
+}
+
+} // namespace
+
+EquityResult range_vs_range(const HandRange& hero, const HandRange& villain,
+                            const std::vector<int>& board, const EquityOptions& options) {
+    const Problem p = prepare(hero, villain, board);
+    const int threads = resolve_threads(options.threads);
+
+    const int deck_size = kNumCards - 4 - static_cast<int>(board.size());
+    const std::uint64_t exact_cost = binomial(deck_size, p.runout_cards) * p.num_matchups;
+    if (exact_cost <= options.max_exact_showdowns) {
+        return solve_exact(p, threads);
+    }
+    return solve_monte_carlo(p, threads, options);
+}
+
+EquityResult hand_vs_range(const std::array<int, 2>& hero, const HandRange& villain,
+                           const std::vector<int>& board, const EquityOptions& options) {
+    return range_vs_range(HandRange{RangeEntry{hero, 1.0}}, villain, board, options);
+}
+
+EquityResult hand_vs_hand(const std::array<int, 2>& hero, const std::array<int, 2>& villain,
+                          const std::vector<int>& board, const EquityOptions& options) {
+    return range_vs_range(HandRange{RangeEntry{hero, 1.0}}, HandRange{RangeEntry{villain, 1.0}}, board, options);
+}
+
+} // namespace poker
@@ -0,0 +1,384 @@
+#include "poker/hand_eval.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if !defined(POKER_NO_AVX2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define POKER_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#else
+#define POKER_HAVE_AVX2_KERNEL 0
+#endif
+
+namespace poker {
+
+namespace {
+
+constexpr int kRankMasks = 1 << 13;
+constexpr std::uint32_t kRankBits = kRankMasks - 1;
+
+constexpr int kP1 = 15;
+constexpr int kP2 = kP1 * 15;
+constexpr int kP3 = kP2 * 15;
+constexpr int kP4 = kP3 * 15;
+constexpr int kP5 = kP4 * 15;
+
+// Bit i of a rank mask is rank i + 2.
+constexpr std::uint32_t rank_bit(int rank) {
+    return 1u << (rank - 2);
+}
+
+constexpr std::array<std::uint8_t, kRankMasks> make_bit_count_table() {
+    std::array<std::uint8_t, kRankMasks> t{};
+    for (int m = 1; m < kRankMasks; ++m) {
+        t[static_cast<std::size_t>(m)] = static_cast<std::uint8_t>(t[static_cast<std::size_t>(m & (m - 1))] + 1);
+    }
+    return t;
+}
+
+// Highest five ranks of the mask packed into the five kicker slots (slot 0 = highest).
+// Masks with fewer ranks leave the trailing slots at zero, like pack_score did.
+constexpr std::array<std::int32_t, kRankMasks> make_top5_table() {
+    std::array<std::int32_t, kRankMasks> t{};
+    for (int m = 0; m < kRankMasks; ++m) {
+        int packed = 0;
+        int taken = 0;
+        for (int r = 14; r >= 2 && taken < 5; --r) {
+            if (m & static_cast<int>(rank_bit(r))) {
+                packed = packed * 15 + r;
+                ++taken;
+            }
+        }
+        for (; taken < 5; ++taken) {
+            packed *= 15;
+        }
+        t[static_cast<std::size_t>(m)] = packed;
+    }
+    return t;
+}
+
+// High rank of the best straight contained in the mask, 0 if none. The wheel is 5-high.
+constexpr std::array<std::uint8_t, kRankMasks> make_straight_table() {
+    std::array<std::uint8_t, kRankMasks> t{};
+    for (int m = 0; m < kRankMasks; ++m) {
+        int high = 0;
+        for (int top = 14; top >= 6 && high == 0; --top) {
+            const int run = static_cast<int>(rank_bit(top) | rank_bit(top - 1) | rank_bit(top - 2) |
+                                             rank_bit(top - 3) | rank_bit(top - 4));
+            if ((m & run) == run) {
+                high = top;
+            }
+        }
+        const int wheel = static_cast<int>(rank_bit(14) | rank_bit(2) | rank_bit(3) | rank_bit(4) | rank_bit(5));
+        if (high == 0 && (m & wheel) == wheel) {
+            high = 5;
+        }
+        t[static_cast<std::size_t>(m)] = static_cast<std::uint8_t>(high);
+    }
+    return t;
+}
+
+constexpr std::array<std::uint8_t, kRankMasks> kBitCount = make_bit_count_table();
+constexpr std::array<std::int32_t, kRankMasks> kTop5 = make_top5_table();
+constexpr std::array<std::uint8_t, kRankMasks> kStraightHigh = make_straight_table();
+
+inline int bit_count(std::uint32_t m) {
+    return kBitCount[m];
+}
+
+inline int top5(std::uint32_t m) {
+    return kTop5[m];
+}
+
+inline int top_rank(std::uint32_t m) {
+    return kTop5[m] / kP4;
+}
+
+inline int flush_score(std::uint32_t suited) {
+    const int high = kStraightHigh[suited];
+    if (high != 0) {
+        return 8 * kP5 + high * kP4;
+    }
+    return 5 * kP5 + top5(suited);
+}
+
+// Best non-flush hand from rank masks by multiplicity: held at least once, twice, three and four times.
+inline int evaluate_multiplicity(std::uint32_t m1, std::uint32_t m2, std::uint32_t m3, std::uint32_t m4) {
+    if (m4 != 0) {
+        const int quad = top_rank(m4);
+        return 7 * kP5 + quad * kP4 + top_rank(m1 & ~rank_bit(quad)) * kP3;
+    }
+
+    int trips = 0;
+    if (m3 != 0) {
+        trips = top_rank(m3);
+        const std::uint32_t pairs = m2 & ~rank_bit(trips);
+        if (pairs != 0) {
+            return 6 * kP5 + trips * kP4 + top_rank(pairs) * kP3;
+        }
+    }
+
+    const int straight = kStraightHigh[m1];
+    if (straight != 0) {
+        return 4 * kP5 + straight * kP4;
+    }
+
+    if (trips != 0) {
+        const std::uint32_t kickers = m1 & ~rank_bit(trips);
+        return 3 * kP5 + trips * kP4 + (top5(kickers) / kP3) * kP2;
+    }
+
+    if (m2 != 0) {
+        const int high_pair = top_rank(m2);
+        const std::uint32_t lower_pairs = m2 & ~rank_bit(high_pair);
+        if (lower_pairs != 0) {
+            const int low_pair = top_rank(lower_pairs);
+            const std::uint32_t kickers = m1 & ~(rank_bit(high_pair) | rank_bit(low_pair));
+            return 2 * kP5 + high_pair * kP4 + low_pair * kP3 + top_rank(kickers) * kP2;
+        }
+        const std::uint32_t kickers = m1 & ~rank_bit(high_pair);
+        return 1 * kP5 + high_pair * kP4 + (top5(kickers) / kP2) * kP1;
+    }
+
+    return top5(m1);
+}
+
+inline int evaluate_suit_masks(std::uint32_t s0, std::uint32_t s1, std::uint32_t s2, std::uint32_t s3) {
+    // Five suited cards out of seven rule out quads and full houses, so a flush decides the hand.
+    for (const std::uint32_t s : {s0, s1, s2, s3}) {
+        if (bit_count(s) >= 5) {
+            return flush_score(s);
+        }
+    }
+
+    const std::uint32_t m1 = s0 | s1 | s2 | s3;
+    const std::uint32_t m2 = (s0 & s1) | (s2 & s3) | ((s0 | s1) & (s2 | s3));
+    const std::uint32_t m3 = (s0 & s1 & (s2 | s3)) | (s2 & s3 & (s0 | s1));
+    const std::uint32_t m4 = s0 & s1 & s2 & s3;
+    return evaluate_multiplicity(m1, m2, m3, m4);
+}
+
+// Per-board lookup tables for batch evaluation. With the board fixed, the non-flush score
+// depends only on the two hole ranks and the flush score only on which hole ranks share
+// the board's flush suit, so each holding reduces to two small table reads.
+struct BoardTables {
+    CardSet board;
+    int flush_suit = -1;
+    // [r0 * 13 + r1], symmetric; -1 where the ranks cannot coexist with the board.
+    std::array<std::int32_t, 13 * 13> rank_pair{};
+    // [f0 * 14 + f1] with f = rank index if the hole card has the flush suit, else 13.
+    std::array<std::int32_t, 14 * 14> flush{};
+    // -1 for cards on the board, 0 otherwise; padded so any 6-bit index is safe.
+    std::array<std::int32_t, 64> on_board{};
+};
+
+// Adds one rank to multiplicity masks m[0..3]; false if the rank is already held four times.
+inline bool add_rank(std::array<std::uint32_t, 4>& m, int rank_index) {
+    const std::uint32_t b = 1u << rank_index;
+    for (std::uint32_t& level : m) {
+        if ((level & b) == 0) {
+            level |= b;
+            return true;
+        }
+    }
+    return false;
+}
+
+void build_board_tables(const std::array<int, 5>& board, BoardTables& t) {
+    std::array<std::uint32_t, 4> board_levels{};
+    std::array<std::uint32_t, 4> suit_masks{};
+    t.board = CardSet::from(board);
+    t.on_board.fill(0);
+    for (int c : board) {
+        t.on_board[static_cast<std::size_t>(c)] = -1;
+        add_rank(board_levels, c % 13);
+        suit_masks[static_cast<std::size_t>(c / 13)] |= 1u << (c % 13);
+    }
+
+    for (int r0 = 0; r0 < 13; ++r0) {
+        std::array<std::uint32_t, 4> with_r0 = board_levels;
+        const bool r0_ok = add_rank(with_r0, r0);
+        for (int r1 = r0; r1 < 13; ++r1) {
+            std::array<std::uint32_t, 4> m = with_r0;
+            int score = -1;
+            if (r0_ok && add_rank(m, r1)) {
+                score = evaluate_multiplicity(m[0], m[1], m[2], m[3]);
+            }
+            t.rank_pair[static_cast<std::size_t>(r0 * 13 + r1)] = score;
+            t.rank_pair[static_cast<std::size_t>(r1 * 13 + r0)] = score;
+        }
+    }
+
+    t.flush_suit = -1;
+    t.flush.fill(0);
+    for (int s = 0; s < 4; ++s) {
+        if (bit_count(suit_masks[static_cast<std::size_t>(s)]) >= 3) {
+            t.flush_suit = s;
+        }
+    }
+    if (t.flush_suit < 0) {
+        return;
+    }
+
+    const std::uint32_t base = suit_masks[static_cast<std::size_t>(t.flush_suit)];
+    for (int f0 = 0; f0 < 14; ++f0) {
+        for (int f1 = f0; f1 < 14; ++f1) {
+            std::uint32_t suited = base;
+            suited |= f0 < 13 ? 1u << f0 : 0u;
+            suited |= f1 < 13 ? 1u << f1 : 0u;
+            const int score = bit_count(suited) >= 5 ? flush_score(suited) : 0;
+            t.flush[static_cast<std::size_t>(f0 * 14 + f1)] = score;
+            t.flush[static_cast<std::size_t>(f1 * 14 + f0)] = score;
+        }
+    }
+}
+
+void evaluate_batch_scalar(const BoardTables& t, const std::array<int, 2>* holes, std::size_t count, int* out) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const int c0 = holes[i][0];
+        const int c1 = holes[i][1];
+        if (c0 == c1 || t.board.contains(c0) || t.board.contains(c1)) {
+            out[i] = -1;
+            continue;
+        }
+        const int r0 = c0 % 13;
+        const int r1 = c1 % 13;
+        const int f0 = c0 / 13 == t.flush_suit ? r0 : 13;
+        const int f1 = c1 / 13 == t.flush_suit ? r1 : 13;
+        const int plain = t.rank_pair[static_cast<std::size_t>(r0 * 13 + r1)];
+        const int flush = t.flush[static_cast<std::size_t>(f0 * 14 + f1)];
+        out[i] = flush > plain ? flush : plain;
+    }
+}
+
+#if POKER_HAVE_AVX2_KERNEL
+
+__attribute__((target("avx2")))
+void evaluate_batch_avx2(const BoardTables& t, const std::array<int, 2>* holes, std::size_t count, int* out) {
+    const int* cards = holes[0].data();
+    const __m256i pair_stride = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i thirteen = _mm256_set1_epi32(13);
+    const __m256i fourteen = _mm256_set1_epi32(14);
+    const __m256i div13_mul = _mm256_set1_epi32(79);
+    const __m256i flush_suit = _mm256_set1_epi32(t.flush_suit);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int* base = cards + 2 * i;
+        const __m256i c0 = _mm256_i32gather_epi32(base, pair_stride, 4);
+        const __m256i c1 = _mm256_i32gather_epi32(base + 1, pair_stride, 4);
+
+        // card / 13 == (card * 79) >> 10 for every card in 0..51.
+        const __m256i s0 = _mm256_srli_epi32(_mm256_mullo_epi32(c0, div13_mul), 10);
+        const __m256i s1 = _mm256_srli_epi32(_mm256_mullo_epi32(c1, div13_mul), 10);
+        const __m256i r0 = _mm256_sub_epi32(c0, _mm256_mullo_epi32(s0, thirteen));
+        const __m256i r1 = _mm256_sub_epi32(c1, _mm256_mullo_epi32(s1, thirteen));
+
+        const __m256i f0 = _mm256_blendv_epi8(thirteen, r0, _mm256_cmpeq_epi32(s0, flush_suit));
+        const __m256i f1 = _mm256_blendv_epi8(thirteen, r1, _mm256_cmpeq_epi32(s1, flush_suit));
+
+        const __m256i plain_idx = _mm256_add_epi32(_mm256_mullo_epi32(r0, thirteen), r1);
+        const __m256i flush_idx = _mm256_add_epi32(_mm256_mullo_epi32(f0, fourteen), f1);
+        const __m256i plain = _mm256_i32gather_epi32(t.rank_pair.data(), plain_idx, 4);
+        const __m256i flush = _mm256_i32gather_epi32(t.flush.data(), flush_idx, 4);
+        const __m256i score = _mm256_max_epi32(plain, flush);
+
+        const __m256i conflict = _mm256_or_si256(
+            _mm256_or_si256(_mm256_i32gather_epi32(t.on_board.data(), c0, 4),
+                            _mm256_i32gather_epi32(t.on_board.data(), c1, 4)),
+            _mm256_cmpeq_epi32(c0, c1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_blendv_epi8(score, minus_one, conflict));
+    }
+
+    evaluate_batch_scalar(t, holes + i, count - i, out + i);
+}
+
+bool cpu_has_avx2() {
+    static const bool has = __builtin_cpu_supports("avx2") != 0;
+    return has;
+}
+
+#endif
+
+} // namespace
+
+int evaluate_card_mask(std::uint64_t card_mask) {
+    return evaluate_suit_masks(static_cast<std::uint32_t>(card_mask) & kRankBits,
+                               static_cast<std::uint32_t>(card_mask >> 13) & kRankBits,
+                               static_cast<std::uint32_t>(card_mask >> 26) & kRankBits,
+                               static_cast<std::uint32_t>(card_mask >> 39) & kRankBits);
+}
+
+int evaluate_7cards(const std::array<int, 7>& cards) {
+    return evaluate_cards(CardSet::from(cards));
+}
+
+int evaluate_hand(const std::array<int, 2>& hole, const std::array<int, 5>& board) {
+    return evaluate_cards(CardSet::of(hole) | CardSet::from(board));
+}
+
+HandAccumulator::HandAccumulator(CardSet cards) {
+    for (int c : cards) {
+        add(c);
+    }
+}
+
+HandAccumulator::HandAccumulator(const std::array<int, 2>& hole, const std::vector<int>& board) {
+    add(hole[0]);
+    add(hole[1]);
+    for (int c : board) {
+        add(c);
+    }
+}
+
+int HandAccumulator::score() const {
+    for (int s = 0; s < 4; ++s) {
+        const std::uint32_t suited = static_cast<std::uint32_t>(cards_.mask() >> (13 * s)) & kRankBits;
+        if (bit_count(suited) >= 5) {
+            return flush_score(suited);
+        }
+    }
+    return evaluate_multiplicity(levels_[0], levels_[1], levels_[2], levels_[3]);
+}
+
+int HandAccumulator::score_with(int card) const {
+    const int rank_index = card % 13;
+    const int suit = card / 13;
+
+    // Only the new card's suit can newly reach five; another suit may already hold five.
+    const std::uint32_t suited = (static_cast<std::uint32_t>(cards_.mask() >> (13 * suit)) & kRankBits) | (1u << rank_index);
+    if (bit_count(suited) >= 5) {
+        return flush_score(suited);
+    }
+    for (int s = 0; s < 4; ++s) {
+        const std::uint32_t other = static_cast<std::uint32_t>(cards_.mask() >> (13 * s)) & kRankBits;
+        if (s != suit && bit_count(other) >= 5) {
+            return flush_score(other);
+        }
+    }
+
+    std::array<std::uint32_t, 4> m = levels_;
+    add_rank(m, rank_index);
+    return evaluate_multiplicity(m[0], m[1], m[2], m[3]);
+}
+
+void evaluate_board_batch(const std::array<int, 5>& board, const std::array<int, 2>* holes, std::size_t count, int* out) {
+    BoardTables tables;
+    build_board_tables(board, tables);
+#if POKER_HAVE_AVX2_KERNEL
+    if (cpu_has_avx2()) {
+        evaluate_batch_avx2(tables, holes, count, out);
+        return;
+    }
+#endif
+    evaluate_batch_scalar(tables, holes, count, out);
+}
+
+void evaluate_board_batch(const std::array<int, 5>& board, const std::vector<std::array<int, 2>>& holes, std::vector<int>& out) {
+    out.resize(holes.size());
+    evaluate_board_batch(board, holes.data(), holes.size(), out.data());
+}
+
+} // namespace poker
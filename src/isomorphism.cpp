@@ -0,0 +1,166 @@
+#include "poker/isomorphism.hpp"
+
+#include "poker/card_set.hpp"
+#include "poker/cards.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace poker {
+
+namespace {
+
+constexpr std::uint64_t kSuitBits = (std::uint64_t{1} << kNumRanks) - 1;
+
+std::uint64_t mask_of(const std::vector<int>& cards) {
+    return CardSet::from(cards).mask();
+}
+
+std::uint64_t map_mask(std::uint64_t mask, const SuitPermutation& perm) {
+    std::uint64_t out = 0;
+    for (int s = 0; s < kNumSuits; ++s) {
+        const std::uint64_t suited = (mask >> (kNumRanks * s)) & kSuitBits;
+        out |= suited << (kNumRanks * perm[static_cast<std::size_t>(s)]);
+    }
+    return out;
+}
+
+std::vector<int> cards_of(std::uint64_t mask) {
+    const CardSet cards(mask);
+    return std::vector<int>(cards.begin(), cards.end());
+}
+
+} // namespace
+
+int apply_suit_permutation(int card, const SuitPermutation& perm) {
+    return make_card(card_rank_index(card), perm[static_cast<std::size_t>(card_suit(card))]);
+}
+
+std::array<int, 2> apply_suit_permutation(const std::array<int, 2>& hole, const SuitPermutation& perm) {
+    std::array<int, 2> out{apply_suit_permutation(hole[0], perm), apply_suit_permutation(hole[1], perm)};
+    if (out[0] > out[1]) {
+        std::swap(out[0], out[1]);
+    }
+    return out;
+}
+
+SuitPermutation inverse_permutation(const SuitPermutation& perm) {
+    SuitPermutation inv{};
+    for (int s = 0; s < kNumSuits; ++s) {
+        inv[static_cast<std::size_t>(perm[static_cast<std::size_t>(s)])] = s;
+    }
+    return inv;
+}
+
+SuitPermutation canonical_permutation(const std::vector<std::uint64_t>& round_masks) {
+    std::array<int, 4> order{0, 1, 2, 3};
+    const auto suit_round = [&](int suit, std::size_t round) {
+        return (round_masks[round] >> (kNumRanks * suit)) & kSuitBits;
+    };
+    // Richer suits first: compare rank masks round by round, larger mask first.
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        for (std::size_t r = 0; r < round_masks.size(); ++r) {
+            const std::uint64_t ma = suit_round(a, r);
+            const std::uint64_t mb = suit_round(b, r);
+            if (ma != mb) {
+                return ma > mb;
+            }
+        }
+        return false;
+    });
+
+    SuitPermutation perm{};
+    for (int i = 0; i < kNumSuits; ++i) {
+        perm[static_cast<std::size_t>(order[static_cast<std::size_t>(i)])] = i;
+    }
+    return perm;
+}
+
+CanonicalBoard canonicalize_board(const std::vector<int>& board) {
+    CanonicalBoard out;
+    const std::uint64_t mask = mask_of(board);
+    out.perm = canonical_permutation({mask});
+    out.key = map_mask(mask, out.perm);
+    out.cards = cards_of(out.key);
+    return out;
+}
+
+CanonicalSpot canonicalize(const std::vector<int>& board, const std::vector<std::array<int, 2>>& holdings) {
+    std::vector<std::uint64_t> rounds;
+    rounds.reserve(holdings.size() + 1);
+    rounds.push_back(mask_of(board));
+    for (const auto& h : holdings) {
+        rounds.push_back(CardSet::of(h).mask());
+    }
+
+    CanonicalSpot out;
+    out.board.perm = canonical_permutation(rounds);
+    out.board.key = map_mask(rounds[0], out.board.perm);
+    out.board.cards = cards_of(out.board.key);
+    out.holdings.reserve(holdings.size());
+    for (const auto& h : holdings) {
+        out.holdings.push_back(apply_suit_permutation(h, out.board.perm));
+    }
+    return out;
+}
+
+std::vector<WeightedBoard> canonical_boards(int num_cards) {
+    if (num_cards < 0 || num_cards > 5) {
+        throw std::invalid_argument("canonical_boards supports 0..5 cards");
+    }
+
+    std::map<std::uint64_t, int> counts;
+    std::array<int, 5> idx{};
+    // Enumerate every k-subset of the deck in lexicographic order.
+    for (int i = 0; i < num_cards; ++i) {
+        idx[static_cast<std::size_t>(i)] = i;
+    }
+    while (true) {
+        std::uint64_t mask = 0;
+        for (int i = 0; i < num_cards; ++i) {
+            mask |= std::uint64_t{1} << idx[static_cast<std::size_t>(i)];
+        }
+        counts[map_mask(mask, canonical_permutation({mask}))]++;
+
+        int i = num_cards - 1;
+        while (i >= 0 && idx[static_cast<std::size_t>(i)] == kNumCards - num_cards + i) {
+            --i;
+        }
+        if (i < 0) {
+            break;
+        }
+        idx[static_cast<std::size_t>(i)]++;
+        for (int j = i + 1; j < num_cards; ++j) {
+            idx[static_cast<std::size_t>(j)] = idx[static_cast<std::size_t>(j) - 1] + 1;
+        }
+    }
+
+    std::vector<WeightedBoard> out;
+    out.reserve(counts.size());
+    for (const auto& [key, weight] : counts) {
+        out.push_back(WeightedBoard{cards_of(key), weight});
+    }
+    return out;
+}
+
+std::vector<WeightedCard> canonical_next_cards(const std::vector<int>& board) {
+    const CardSet board_cards = CardSet::from(board);
+    std::map<std::uint64_t, std::size_t> slot;
+    std::vector<WeightedCard> out;
+    for (int c : board_cards.complement()) {
+        const std::uint64_t card_mask = CardSet::of(c).mask();
+        const SuitPermutation perm = canonical_permutation({board_cards.mask(), card_mask});
+        // The board round is ordered first, so it maps to the same canonical board for every
+        // card and the mapped card alone identifies the class.
+        const std::uint64_t key = map_mask(card_mask, perm);
+        const auto [it, inserted] = slot.emplace(key, out.size());
+        if (inserted) {
+            out.push_back(WeightedCard{c, 0});
+        }
+        out[it->second].weight++;
+    }
+    return out;
+}
+
+} // namespace poker
@@ -1,5 +1,7 @@
 #include "poker/engine.hpp"
+#include "poker/simulator.hpp"
 
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <vector>
@@ -120,53 +122,32 @@ void run_interactive_hand(poker::Engine& engine, int human_player) {
 int main() {
     poker::Engine engine(1337);
 
-    const int mode = read_int_with_prompt("Select mode (0=interactive, 1=auto 10 hands): ", 0, 1);
+    const int mode = read_int_with_prompt("Select mode (0=interactive, 1=auto simulation): ", 0, 1);
     if (mode == 0) {
         const int human_player = read_int_with_prompt("Control which player? (0 or 1): ", 0, 1);
         run_interactive_hand(engine, human_player);
         return 0;
     }
 
-    constexpr int kHands = 10;
-    int folds = 0;
-    int showdowns = 0;
-
-    for (int h = 0; h < kHands; ++h) {
-        poker::State state = engine.new_hand();
-
-        int guard = 0;
-        while (state.street != poker::Street::Terminal && guard < 200) {
-            auto action = engine.random_legal_action(state);
-            const bool ok = engine.apply_action(state, action);
-            if (!ok) {
-                std::cerr << "Illegal action selected; aborting hand " << h << "\n";
-                return 1;
-            }
-            ++guard;
-        }
-
-        if (guard >= 200) {
-            std::cerr << "Guard reached; potential infinite loop in hand " << h << "\n";
-            return 2;
-        }
-
-        poker::TerminalResult result = engine.terminal_payoff(state);
-        if (!result.is_terminal) {
-            std::cerr << "Terminal payoff requested on non-terminal state\n";
-            return 3;
-        }
-        
-        if (result.reason == "fold") {
-            ++folds;
-        } else if (result.reason == "showdown") {
-            ++showdowns;
-        }
-
-        print_terminal_state(h, state, result);
+    const int hands = read_int_with_prompt("Hands to simulate: ", 1, 1000000000);
+    const bool print_hands = read_int_with_prompt("Print every hand? (0=no, 1=yes): ", 0, 1) == 1;
+
+    poker::SimulationOptions options;
+    options.hands = static_cast<std::uint64_t>(hands);
+    options.seed = 1337;
+    poker::HandObserver observer;
+    if (print_hands) {
+        // Printing needs the hands in order, so keep them on one thread.
+        options.threads = 1;
+        observer = [](std::uint64_t h, const poker::State& state, const poker::TerminalResult& result) {
+            print_terminal_state(static_cast<int>(h), state, result);
+        };
     }
+    const poker::SimulationStats stats = poker::simulate(engine.rules(), options, observer);
 
-    std::cout << "Simulated " << kHands << " hands successfully\n";
-    std::cout << "fold outcomes: " << folds << "\n";
-    std::cout << "showdown outcomes: " << showdowns << "\n";
+    std::cout << "Simulated " << stats.hands << " hands successfully\n";
+    std::cout << "fold outcomes: " << stats.folds << "\n";
+    std::cout << "showdown outcomes: " << stats.showdowns << "\n";
+    std::cout << "p0 chips per hand: " << stats.p0_ev() << " +- " << stats.p0_ev_std_error() << "\n";
     return 0;
 }
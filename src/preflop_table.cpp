@@ -0,0 +1,112 @@
+#include "poker/preflop_table.hpp"
+
+#include "poker/cards.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace poker {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'K', 'P', 'F', 'E', 'Q', 'T', '\0'};
+
+std::uint64_t fnv1a64(const void* data, std::size_t size) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+constexpr std::size_t kPayloadBytes = sizeof(float) * kNumPreflopClasses * kNumPreflopClasses;
+
+} // namespace
+
+int preflop_class(const std::array<int, 2>& hole) {
+    const int r0 = card_rank_index(hole[0]);
+    const int r1 = card_rank_index(hole[1]);
+    const int hi = r0 > r1 ? r0 : r1;
+    const int lo = r0 > r1 ? r1 : r0;
+    if (card_suit(hole[0]) == card_suit(hole[1])) {
+        return hi * kNumRanks + lo;
+    }
+    return lo * kNumRanks + hi;
+}
+
+std::string preflop_class_name(int cls) {
+    static const char kRankChars[] = "23456789TJQKA";
+    const int row = cls / kNumRanks;
+    const int col = cls % kNumRanks;
+    std::string out;
+    if (row == col) {
+        out += kRankChars[row];
+        out += kRankChars[row];
+    } else if (row > col) {
+        out += kRankChars[row];
+        out += kRankChars[col];
+        out += 's';
+    } else {
+        out += kRankChars[col];
+        out += kRankChars[row];
+        out += 'o';
+    }
+    return out;
+}
+
+void write_preflop_table(const std::string& path, const std::vector<float>& equities, std::uint64_t samples_per_matchup) {
+    if (equities.size() != static_cast<std::size_t>(kNumPreflopClasses) * kNumPreflopClasses) {
+        throw std::runtime_error("preflop table must have 169 x 169 entries");
+    }
+
+    PreflopTableHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kPreflopTableVersion;
+    h.byte_order = kPreflopTableByteOrder;
+    h.num_classes = kNumPreflopClasses;
+    h.flags = samples_per_matchup == 0 ? kPreflopTableExact : 0;
+    h.samples_per_matchup = samples_per_matchup;
+    h.checksum = fnv1a64(equities.data(), kPayloadBytes);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(equities.data()), static_cast<std::streamsize>(kPayloadBytes));
+    if (!out) {
+        throw std::runtime_error("failed to write preflop table " + path);
+    }
+}
+
+const PreflopTableHeader& PreflopEquityTable::header() const {
+    return *reinterpret_cast<const PreflopTableHeader*>(file_.data());
+}
+
+PreflopEquityTable PreflopEquityTable::open(const std::string& path) {
+    PreflopEquityTable t;
+    t.file_ = MappedFile::open(path);
+    if (t.file_.size() != sizeof(PreflopTableHeader) + kPayloadBytes) {
+        throw std::runtime_error("preflop table " + path + " has unexpected size");
+    }
+
+    const PreflopTableHeader& h = t.header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error(path + " is not a preflop equity table");
+    }
+    if (h.byte_order != kPreflopTableByteOrder) {
+        throw std::runtime_error("preflop table " + path + " was written with a different byte order");
+    }
+    if (h.version != kPreflopTableVersion || h.num_classes != kNumPreflopClasses) {
+        throw std::runtime_error("preflop table " + path + " has unsupported version");
+    }
+
+    const unsigned char* payload = t.file_.data() + sizeof(PreflopTableHeader);
+    if (fnv1a64(payload, kPayloadBytes) != h.checksum) {
+        throw std::runtime_error("preflop table " + path + " failed checksum");
+    }
+    t.equities_ = reinterpret_cast<const float*>(payload);
+    return t;
+}
+
+} // namespace poker
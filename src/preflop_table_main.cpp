@@ -0,0 +1,180 @@
+#include "poker/card_set.hpp"
+#include "poker/cards.hpp"
+#include "poker/equity.hpp"
+#include "poker/isomorphism.hpp"
+#include "poker/preflop_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string out_path = "preflop_equity.bin";
+    int threads = 0;
+    std::uint64_t samples = 0; // 0 = exact enumeration
+};
+
+void print_usage() {
+    std::cerr << "usage: poker_preflop_table [--out PATH] [--threads N] [--samples N]\n"
+              << "  --samples N  Monte Carlo boards per matchup, rounded up to a multiple of 4096\n"
+              << "               (default 0 = exact enumeration)\n";
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        if (arg == "--out") {
+            opt.out_path = argv[++i];
+        } else if (arg == "--threads") {
+            opt.threads = std::atoi(argv[++i]);
+        } else if (arg == "--samples") {
+            opt.samples = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Matchups identical up to a suit relabelling have identical equity, so they share the
+// key of their canonical form.
+std::uint32_t canonical_matchup(const std::array<int, 2>& hero, const std::array<int, 2>& villain) {
+    const poker::CanonicalSpot spot = poker::canonicalize({}, {hero, villain});
+    const auto& h = spot.holdings[0];
+    const auto& v = spot.holdings[1];
+    return static_cast<std::uint32_t>((h[0] << 18) | (h[1] << 12) | (v[0] << 6) | v[1]);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        print_usage();
+        return 1;
+    }
+    if (opt.threads <= 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        opt.threads = hw == 0 ? 1 : static_cast<int>(hw);
+    }
+
+    std::array<std::vector<std::array<int, 2>>, poker::kNumPreflopClasses> combos_by_class;
+    for (int i = 0; i < poker::kNumCombos; ++i) {
+        const auto& cards = poker::combo_cards(i);
+        combos_by_class[static_cast<std::size_t>(poker::preflop_class(cards))].push_back(cards);
+    }
+
+    // Collect the distinct matchups up to suit isomorphism.
+    std::unordered_map<std::uint32_t, float> matchup_equity;
+    std::vector<std::uint32_t> keys;
+    for (int a = 0; a < poker::kNumPreflopClasses; ++a) {
+        for (int b = a + 1; b < poker::kNumPreflopClasses; ++b) {
+            for (const auto& h : combos_by_class[static_cast<std::size_t>(a)]) {
+                for (const auto& v : combos_by_class[static_cast<std::size_t>(b)]) {
+                    if (poker::CardSet::of(h).intersects(poker::CardSet::of(v))) {
+                        continue;
+                    }
+                    const std::uint32_t key = canonical_matchup(h, v);
+                    if (matchup_equity.emplace(key, 0.0f).second) {
+                        keys.push_back(key);
+                    }
+                }
+            }
+        }
+    }
+    std::cerr << "distinct matchups: " << keys.size() << " (" << (opt.samples == 0 ? "exact" : "monte carlo")
+              << ", " << opt.threads << " threads)\n";
+
+    std::vector<float> results(keys.size());
+    std::vector<std::uint64_t> showdowns(keys.size());
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::mutex log_mutex;
+    const auto worker = [&]() {
+        poker::EquityOptions eo;
+        eo.threads = 1;
+        if (opt.samples > 0) {
+            eo.max_exact_showdowns = 0;
+            eo.target_std_error = 0.0;
+            eo.max_samples = opt.samples;
+        }
+        for (std::size_t i = next.fetch_add(1); i < keys.size(); i = next.fetch_add(1)) {
+            const std::uint32_t k = keys[i];
+            const std::array<int, 2> hero{static_cast<int>((k >> 18) & 63), static_cast<int>((k >> 12) & 63)};
+            const std::array<int, 2> villain{static_cast<int>((k >> 6) & 63), static_cast<int>(k & 63)};
+            eo.seed = k;
+            const poker::EquityResult r = poker::hand_vs_hand(hero, villain, {}, eo);
+            results[i] = static_cast<float>(r.equity);
+            showdowns[i] = r.showdowns;
+
+            const std::size_t n = done.fetch_add(1) + 1;
+            if (n % 1000 == 0 || n == keys.size()) {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                std::cerr << "  " << n << " / " << keys.size() << "\n";
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < opt.threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        matchup_equity[keys[i]] = results[i];
+    }
+
+    // Class equity is the mean over all card-compatible combo pairs; the mirrored entry is
+    // its complement and a class against itself is exactly 0.5 by symmetry.
+    std::vector<float> table(static_cast<std::size_t>(poker::kNumPreflopClasses) * poker::kNumPreflopClasses, 0.5f);
+    for (int a = 0; a < poker::kNumPreflopClasses; ++a) {
+        for (int b = a + 1; b < poker::kNumPreflopClasses; ++b) {
+            double sum = 0.0;
+            int n = 0;
+            for (const auto& h : combos_by_class[static_cast<std::size_t>(a)]) {
+                for (const auto& v : combos_by_class[static_cast<std::size_t>(b)]) {
+                    if (poker::CardSet::of(h).intersects(poker::CardSet::of(v))) {
+                        continue;
+                    }
+                    sum += matchup_equity.at(canonical_matchup(h, v));
+                    ++n;
+                }
+            }
+            const double eq = sum / n;
+            table[static_cast<std::size_t>(a * poker::kNumPreflopClasses + b)] = static_cast<float>(eq);
+            table[static_cast<std::size_t>(b * poker::kNumPreflopClasses + a)] = static_cast<float>(1.0 - eq);
+        }
+    }
+
+    // Monte Carlo runs whole chunks of boards, so the header records the count actually run
+    // rather than the one requested; with no error target every matchup runs the same count.
+    const std::uint64_t samples_run = opt.samples == 0 ? 0 : *std::max_element(showdowns.begin(), showdowns.end());
+    if (samples_run != opt.samples) {
+        std::cerr << "ran " << samples_run << " boards per matchup\n";
+    }
+
+    try {
+        poker::write_preflop_table(opt.out_path, table, samples_run);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+    std::cout << "wrote " << opt.out_path << "\n";
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "poker/rules.hpp"
+
+#include "poker/hand_eval.hpp"
+#include "poker/rules_core.hpp"
+#include "poker/zobrist.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+
+namespace poker {
+
+namespace {
+
+void check_action_log(const RulesConfig& config, int starting_stack, int small_blind, int big_blind) {
+    if (max_hand_actions(config, starting_stack, small_blind, big_blind) > kMaxHistory) {
+        throw std::invalid_argument("bet sizes, raise cap and stacks allow hands longer than the action log");
+    }
+}
+
+} // namespace
+
+std::size_t max_hand_actions(const RulesConfig& config, int starting_stack, int small_blind, int big_blind) {
+    const double smallest = *std::min_element(config.bet_sizes.begin(), config.bet_sizes.end());
+    const std::int64_t all_in_pot = 2 * static_cast<std::int64_t>(std::max(0, starting_stack));
+    const std::int64_t cap = 4 * static_cast<std::int64_t>(std::max(0, config.max_raises_per_street));
+    std::int64_t aggressive = 0;
+    for (std::int64_t pot = std::max(1, small_blind + big_blind); pot < all_in_pot && aggressive < cap; ++aggressive) {
+        pot += std::max<std::int64_t>(1, static_cast<std::int64_t>(static_cast<double>(pot) * smallest));
+    }
+    return static_cast<std::size_t>(2 * 4 + 1 + aggressive);
+}
+
+Rules::Rules(const RulesConfig& config) : config_(config) {
+    check_action_log(config_, config_.starting_stack, config_.small_blind, config_.big_blind);
+}
+
+template <typename Rng>
+int Rules::draw_card(State& state, Rng& rng) const {
+    const int c = state.deck.deal(rng);
+    state.used_cards.insert(c);
+    return c;
+}
+
+template <typename Rng>
+void Rules::deal_board(State& state, std::size_t cards, Rng& rng, UndoRecord& undo) const {
+    for (std::size_t i = 0; i < cards; ++i) {
+        const std::size_t k = state.board.size() - undo.board_size;
+        const int c = state.deck.deal(rng, undo.deal_from[k]);
+        state.used_cards.insert(c);
+        state.board.push_back(c);
+        state.hash += zobrist::key(zobrist::BoardCard, c);
+    }
+}
+
+template <typename Rng>
+State Rules::new_hand(Rng& rng, int starting_stack, int small_blind, int big_blind) const {
+    if (starting_stack != config_.starting_stack || small_blind != config_.small_blind ||
+        big_blind != config_.big_blind) {
+        check_action_log(config_, starting_stack, small_blind, big_blind);
+    }
+    State s;
+    core::post_blinds(s, starting_stack, small_blind, big_blind);
+    for (int p = 0; p < 2; ++p) {
+        s.hole_cards[p][0] = draw_card(s, rng);
+        s.hole_cards[p][1] = draw_card(s, rng);
+        s.hash += zobrist::key(zobrist::Hole, p, s.hole_cards[p][0]) + zobrist::key(zobrist::Hole, p, s.hole_cards[p][1]);
+    }
+    return s;
+}
+
+std::vector<Action> Rules::legal_actions(const State& state) const {
+    ActionBuffer buf;
+    legal_actions(state, buf);
+    return buf.to_vector();
+}
+
+void Rules::legal_actions(const State& state, ActionBuffer& out) const {
+    core::legal_actions(state, config_, out);
+}
+
+bool Rules::is_legal(const State& state, const Action& action) const {
+    return core::is_legal(state, config_, action);
+}
+
+template <typename Rng>
+bool Rules::apply_action(State& state, const Action& action, Rng& rng) const {
+    if (!is_legal(state, action) || state.history.full()) {
+        return false;
+    }
+    apply_action_unchecked(state, action, rng);
+    return true;
+}
+
+template <typename Rng>
+void Rules::apply_action_unchecked(State& state, const Action& action, Rng& rng, UndoRecord& undo) const {
+    assert(is_legal(state, action));
+    assert(!state.history.full());
+
+    const auto p = static_cast<std::size_t>(action.player);
+    undo.street = state.street;
+    undo.to_act = state.to_act;
+    undo.bet_to_call = state.bet_to_call;
+    undo.last_bet_size = state.last_bet_size;
+    undo.current_bet = state.current_bet;
+    undo.committed_this_round = state.committed_this_round;
+    undo.acted_this_round = state.acted_this_round;
+    undo.raises_this_street = state.raises_this_street;
+    undo.hash = state.hash;
+    undo.put = state.committed_total[p];
+    undo.board_size = static_cast<std::uint8_t>(state.board.size());
+
+    state.history.push_back(action);
+    const core::Outcome outcome = core::apply_action(state, action);
+    undo.put = state.committed_total[p] - undo.put;
+
+    if (outcome == core::Outcome::NextStreet) {
+        deal_board(state, state.street == Street::Flop ? 3 : 1, rng, undo);
+    } else if (outcome == core::Outcome::Showdown) {
+        deal_board(state, 5 - state.board.size(), rng, undo);
+    }
+}
+
+void Rules::undo_action(State& state, const UndoRecord& undo) const {
+    assert(!state.history.empty());
+    const Action& action = state.history.back();
+    const auto p = static_cast<std::size_t>(action.player);
+
+    while (state.board.size() > undo.board_size) {
+        const std::size_t k = state.board.size() - 1 - undo.board_size;
+        state.used_cards.erase(state.board.back());
+        state.board.pop_back();
+        state.deck.undeal(undo.deal_from[k]);
+    }
+
+    state.folded[p] = state.folded[p] && action.type != ActionType::Fold;
+    state.stacks[p] += undo.put;
+    state.committed_total[p] -= undo.put;
+    state.pot -= undo.put;
+
+    state.street = undo.street;
+    state.to_act = undo.to_act;
+    state.bet_to_call = undo.bet_to_call;
+    state.last_bet_size = undo.last_bet_size;
+    state.current_bet = undo.current_bet;
+    state.committed_this_round = undo.committed_this_round;
+    state.acted_this_round = undo.acted_this_round;
+    state.raises_this_street = undo.raises_this_street;
+    state.hash = undo.hash;
+    state.history.pop_back();
+}
+
+int Rules::evaluate_7card(const std::array<int, 2>& hole, const std::vector<int>& board) const {
+    assert(board.size() == 5);
+    return evaluate_hand(hole, {board[0], board[1], board[2], board[3], board[4]});
+}
+
+int Rules::evaluate_7card(const std::array<int, 2>& hole, const Board& board) const {
+    assert(board.size() == 5);
+    return evaluate_hand(hole, {board[0], board[1], board[2], board[3], board[4]});
+}
+
+TerminalResult Rules::terminal_payoff(const State& state) const {
+    TerminalResult r;
+    if (state.street != Street::Terminal) {
+        return r;
+    }
+
+    r.is_terminal = true;
+
+    std::array<int, 2> payout{0, 0};
+
+    if (state.folded[0] != state.folded[1]) {
+        const int winner = state.folded[0] ? 1 : 0;
+        r.winner = winner;
+        r.reason = "fold";
+        payout[winner] = state.pot;
+    } else {
+        const int s0 = evaluate_7card(state.hole_cards[0], state.board);
+        const int s1 = evaluate_7card(state.hole_cards[1], state.board);
+        r.reason = "showdown";
+
+        if (s0 > s1) {
+            r.winner = 0;
+            payout[0] = state.pot;
+        } else if (s1 > s0) {
+            r.winner = 1;
+            payout[1] = state.pot;
+        } else {
+            r.winner = -1;
+            payout[0] = state.pot / 2;
+            payout[1] = state.pot - payout[0];
+        }
+    }
+
+    r.chip_delta[0] = payout[0] - state.committed_total[0];
+    r.chip_delta[1] = payout[1] - state.committed_total[1];
+
+    return r;
+}
+
+template State Rules::new_hand(Xoshiro256StarStar&, int, int, int) const;
+template bool Rules::apply_action(State&, const Action&, Xoshiro256StarStar&) const;
+template void Rules::apply_action_unchecked(State&, const Action&, Xoshiro256StarStar&, UndoRecord&) const;
+
+template State Rules::new_hand(Pcg32&, int, int, int) const;
+template bool Rules::apply_action(State&, const Action&, Pcg32&) const;
+template void Rules::apply_action_unchecked(State&, const Action&, Pcg32&, UndoRecord&) const;
+
+} // namespace poker
@@ -0,0 +1,103 @@
+#include "poker/rules.hpp"
+#include "poker/simulator.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct Options {
+    poker::SimulationOptions sim;
+    bool print_hands = false;
+    std::size_t batch_lanes = 0; // 0 = one hand at a time through Rules
+};
+
+void print_usage() {
+    std::cerr << "usage: poker_simulate [--hands N] [--threads N] [--seed N] [--chunk N] [--batch N] [--print]\n"
+              << "  --batch  advance N hands per thread in lock step on a StateBatch\n"
+              << "  --print  print every finished hand (runs on one thread to keep the order)\n";
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--print") {
+            opt.print_hands = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        if (arg == "--hands") {
+            opt.sim.hands = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads") {
+            opt.sim.threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed") {
+            opt.sim.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--chunk") {
+            opt.sim.chunk_hands = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--batch") {
+            opt.batch_lanes = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_hand(std::uint64_t hand, const poker::State& state, const poker::TerminalResult& result) {
+    std::cout << "hand " << hand << ": board";
+    for (int c : state.board) {
+        std::cout << " " << c;
+    }
+    std::cout << " | actions";
+    for (const auto& a : state.history) {
+        std::cout << " " << poker::to_string(a.type);
+        if (a.amount > 0) {
+            std::cout << ":" << a.amount;
+        }
+    }
+    std::cout << " | " << result.reason << " winner=" << result.winner << " p0=" << result.chip_delta[0] << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        print_usage();
+        return 1;
+    }
+    if (opt.print_hands && opt.batch_lanes > 0) {
+        std::cerr << "--print is not available with --batch\n";
+        return 1;
+    }
+    if (opt.print_hands) {
+        opt.sim.threads = 1;
+    }
+
+    const poker::Rules rules;
+    const auto start = std::chrono::steady_clock::now();
+    const poker::SimulationStats stats =
+        opt.batch_lanes > 0
+            ? poker::simulate_batched(rules, opt.sim, opt.batch_lanes)
+            : poker::simulate(rules, opt.sim, opt.print_hands ? poker::HandObserver(print_hand) : poker::HandObserver());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double bb = static_cast<double>(rules.config().big_blind);
+    std::cout << "hands: " << stats.hands << "\n";
+    std::cout << "seconds: " << seconds << "\n";
+    std::cout << "hands_per_second: " << (seconds > 0.0 ? static_cast<double>(stats.hands) / seconds : 0.0) << "\n";
+    std::cout << "fold_rate: " << stats.fold_rate() << "\n";
+    std::cout << "showdown_rate: " << stats.showdown_rate() << "\n";
+    std::cout << "split_pots: " << stats.split_pots << "\n";
+    std::cout << "actions_per_hand: "
+              << (stats.hands == 0 ? 0.0 : static_cast<double>(stats.actions) / static_cast<double>(stats.hands)) << "\n";
+    std::cout << "p0_ev_chips: " << stats.p0_ev() << " +- " << stats.p0_ev_std_error() << "\n";
+    std::cout << "p0_ev_bb_per_100: " << stats.p0_ev() / bb * 100.0 << " +- " << stats.p0_ev_std_error() / bb * 100.0 << "\n";
+    return 0;
+}
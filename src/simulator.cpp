@@ -0,0 +1,216 @@
+#include "poker/simulator.hpp"
+
+#include "poker/rng.hpp"
+#include "poker/state_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace poker {
+
+namespace {
+
+int resolve_threads(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : static_cast<int>(hw);
+}
+
+// No more workers than there are chunks to claim.
+int worker_threads(int requested, std::uint64_t chunks) {
+    return static_cast<int>(std::min<std::uint64_t>(static_cast<std::uint64_t>(resolve_threads(requested)),
+                                                     std::max<std::uint64_t>(1, chunks)));
+}
+
+template <typename Worker>
+void run_workers(int threads, const Worker& worker) {
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<std::size_t>(threads - 1));
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+}
+
+void run_chunk(const Rules& rules, std::uint64_t seed, std::uint64_t first_hand, std::uint64_t count,
+               const HandObserver& observer, SimulationStats& stats) {
+    Xoshiro256StarStar rng(seed);
+    for (std::uint64_t i = 0; i < count; ++i) {
+        State s = rules.new_hand(rng);
+        while (s.street != Street::Terminal) {
+            rules.apply_action_unchecked(s, rules.random_legal_action(s, rng), rng);
+        }
+
+        const TerminalResult r = rules.terminal_payoff(s);
+        const std::int64_t delta = r.chip_delta[0];
+        ++stats.hands;
+        stats.actions += s.history.size();
+        stats.p0_chips += delta;
+        stats.p0_chips_squared += static_cast<std::uint64_t>(delta * delta);
+        if (s.folded[0] || s.folded[1]) {
+            ++stats.folds;
+        } else {
+            ++stats.showdowns;
+            stats.split_pots += r.winner < 0;
+        }
+
+        if (observer) {
+            observer(first_hand + i, s, r);
+        }
+    }
+}
+
+void record_batch_lane(const StateBatch& batch, std::size_t lane, std::int32_t p0_delta, SimulationStats& stats) {
+    const std::int64_t delta = p0_delta;
+    ++stats.hands;
+    stats.actions += static_cast<std::uint64_t>(batch.actions(lane));
+    stats.p0_chips += delta;
+    stats.p0_chips_squared += static_cast<std::uint64_t>(delta * delta);
+    if (batch.folded(lane)) {
+        ++stats.folds;
+    } else {
+        ++stats.showdowns;
+        stats.split_pots += batch.winner(lane) < 0;
+    }
+}
+
+} // namespace
+
+void SimulationStats::merge(const SimulationStats& o) {
+    hands += o.hands;
+    folds += o.folds;
+    showdowns += o.showdowns;
+    split_pots += o.split_pots;
+    actions += o.actions;
+    p0_chips += o.p0_chips;
+    p0_chips_squared += o.p0_chips_squared;
+}
+
+double SimulationStats::fold_rate() const {
+    return hands == 0 ? 0.0 : static_cast<double>(folds) / static_cast<double>(hands);
+}
+
+double SimulationStats::showdown_rate() const {
+    return hands == 0 ? 0.0 : static_cast<double>(showdowns) / static_cast<double>(hands);
+}
+
+double SimulationStats::p0_ev() const {
+    return hands == 0 ? 0.0 : static_cast<double>(p0_chips) / static_cast<double>(hands);
+}
+
+double SimulationStats::p0_ev_std_error() const {
+    if (hands < 2) {
+        return 0.0;
+    }
+    const double n = static_cast<double>(hands);
+    const double mean = static_cast<double>(p0_chips) / n;
+    const double var = (static_cast<double>(p0_chips_squared) - n * mean * mean) / (n - 1.0);
+    return std::sqrt(std::max(0.0, var) / n);
+}
+
+SimulationStats simulate(const Rules& rules, const SimulationOptions& options, const HandObserver& observer) {
+    // run_chunk records every action in the State's fixed log without checking for room.
+    const RulesConfig& config = rules.config();
+    if (max_hand_actions(config, config.starting_stack, config.small_blind, config.big_blind) > kMaxHistory) {
+        throw std::invalid_argument("rules allow hands longer than the action log");
+    }
+
+    const std::uint64_t chunk_hands = std::max<std::uint64_t>(1, options.chunk_hands);
+    const std::uint64_t chunks = (options.hands + chunk_hands - 1) / chunk_hands;
+    const int threads = worker_threads(options.threads, chunks);
+
+    SimulationStats total;
+    std::mutex total_mutex;
+    std::atomic<std::uint64_t> next{0};
+    const auto worker = [&]() {
+        SimulationStats local;
+        for (std::uint64_t c = next.fetch_add(1); c < chunks; c = next.fetch_add(1)) {
+            const std::uint64_t first = c * chunk_hands;
+            const std::uint64_t count = std::min(chunk_hands, options.hands - first);
+            run_chunk(rules, split_mix64(options.seed ^ split_mix64(c)), first, count, observer, local);
+        }
+        std::lock_guard<std::mutex> lock(total_mutex);
+        total.merge(local);
+    };
+
+    run_workers(threads, worker);
+    return total;
+}
+
+SimulationStats simulate_batched(const Rules& rules, const SimulationOptions& options, std::size_t lanes) {
+    const std::uint64_t chunk_hands = std::max<std::uint64_t>(1, options.chunk_hands);
+    const std::uint64_t chunks = (options.hands + chunk_hands - 1) / chunk_hands;
+    const int threads = worker_threads(options.threads, chunks);
+
+    SimulationStats total;
+    std::mutex total_mutex;
+    std::atomic<std::uint64_t> next{0};
+    const auto worker = [&]() {
+        SimulationStats local;
+        std::uint64_t hand = 0;
+        std::uint64_t hand_end = 0;
+        const auto claim = [&](std::uint64_t& out) {
+            if (hand == hand_end) {
+                const std::uint64_t c = next.fetch_add(1);
+                if (c >= chunks) {
+                    return false;
+                }
+                hand = c * chunk_hands;
+                hand_end = std::min(hand + chunk_hands, options.hands);
+            }
+            out = hand++;
+            return true;
+        };
+
+        StateBatch batch(std::max<std::size_t>(1, lanes), rules.config());
+        const std::size_t width = batch.size();
+        std::vector<std::uint8_t> live(width, 0);
+        std::vector<std::int32_t> delta(width, 0);
+        std::size_t live_count = 0;
+        const auto refill = [&](std::size_t lane) {
+            std::uint64_t h = 0;
+            if (claim(h)) {
+                batch.reset(lane, split_mix64(options.seed ^ split_mix64(h)));
+                live[lane] = 1;
+            } else {
+                batch.retire(lane);
+                live[lane] = 0;
+                --live_count;
+            }
+        };
+
+        live_count = width;
+        for (std::size_t i = 0; i < width; ++i) {
+            refill(i);
+        }
+        while (live_count > 0) {
+            batch.compute_legal();
+            batch.choose(kUniformBatchPolicy);
+            batch.apply();
+            batch.payoffs(delta.data());
+            for (std::size_t i = 0; i < width; ++i) {
+                if (live[i] && batch.terminal(i)) {
+                    record_batch_lane(batch, i, delta[i], local);
+                    refill(i);
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(total_mutex);
+        total.merge(local);
+    };
+
+    run_workers(threads, worker);
+    return total;
+}
+
+} // namespace poker
@@ -1,23 +1,114 @@
+#include "poker/preflop_table.hpp"
+#include "poker/static_abstraction.hpp"
 #include "poker/tree.hpp"
+#include "poker/tree_file.hpp"
 
 #include <array>
+#include <cstddef>
+#include <exception>
 #include <iostream>
+#include <optional>
+#include <string>
 
-int main() {
-    poker::BettingAbstraction ab = poker::TreeBuilder::default_abstraction();
+int main(int argc, char** argv) {
+    std::optional<poker::PreflopEquityTable> preflop_table;
+    bool estimate_only = false;
+    std::string save_tree_path;
+    std::string load_tree_path;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--preflop-table" && i + 1 < argc) {
+            try {
+                preflop_table = poker::PreflopEquityTable::open(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        } else if (arg == "--estimate") {
+            estimate_only = true;
+        } else if (arg == "--save-tree" && i + 1 < argc) {
+            save_tree_path = argv[++i];
+        } else if (arg == "--load-tree" && i + 1 < argc) {
+            load_tree_path = argv[++i];
+        } else {
+            std::cerr << "usage: poker_solve [--preflop-table PATH] [--estimate | --save-tree PATH | --load-tree PATH]\n";
+            return 1;
+        }
+    }
 
-    // Keep first solver tree manageable while still non-trivial.
-    ab.max_raises_per_street = 2;
-    ab.bet_sizes_by_street = {
-        std::vector<double>{0.5, 1.0},
-        std::vector<double>{0.5, 1.0},
-        std::vector<double>{1.0},
-        std::vector<double>{1.0}
-    };
-    ab.raise_sizes_by_street = ab.bet_sizes_by_street;
+    // An estimate builds nothing and a loaded tree is not rebuilt, so neither has a tree to
+    // save, and a loaded tree has nothing to estimate.
+    if (static_cast<int>(estimate_only) + !save_tree_path.empty() + !load_tree_path.empty() > 1) {
+        std::cerr << "--estimate, --save-tree and --load-tree cannot be combined\n";
+        return 1;
+    }
 
-    poker::TreeBuilder builder(ab);
-    poker::GameTree tree = builder.build(300000);
+    // A saved tree is mapped instead of rebuilt.
+    poker::MappedGameTree mapped_tree;
+    if (!load_tree_path.empty()) {
+        try {
+            mapped_tree = poker::MappedGameTree::open(load_tree_path);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // Keep first solver tree manageable while still non-trivial: half and full pot through
+    // the flop, full pot on the turn and river, two raises per street.
+    using HalfAndPot = poker::SizeList<poker::PotFraction<1, 2>, poker::PotFraction<1>>;
+    using Pot = poker::SizeList<poker::PotFraction<1>>;
+    using Sizes = poker::StreetSizes<HalfAndPot, HalfAndPot, Pot, Pot>;
+
+    poker::TreeBuilder builder = poker::make_tree_builder(poker::StaticAbstraction<Sizes>{});
+    poker::TreeBuildOptions options;
+    options.max_nodes = 300000;
+
+    poker::GameTree built_tree;
+    if (estimate_only) {
+        // Bounded only by the largest tree node ids can address.
+        const poker::TreeEstimate estimate = builder.estimate();
+        if (estimate.over_limit) {
+            std::cout << "estimated_nodes: over " << poker::kMaxTreeNodes << "\n";
+            return 1;
+        }
+        constexpr std::size_t kRangeSize = 1326;
+        std::cout << "estimated_nodes: " << estimate.total_nodes() << "\n";
+        std::cout << "estimated_decision_nodes: " << estimate.count(poker::NodeType::Decision) << "\n";
+        std::cout << "estimated_chance_nodes: " << estimate.count(poker::NodeType::Chance) << "\n";
+        std::cout << "estimated_terminal_nodes: " << estimate.count(poker::NodeType::Terminal) << "\n";
+        std::cout << "estimated_decision_nodes_by_street:";
+        for (std::size_t street = 0; street < 4; ++street) {
+            std::cout << " " << estimate.nodes[street][static_cast<std::size_t>(poker::NodeType::Decision)];
+        }
+        std::cout << "\n";
+        std::cout << "estimated_tree_bytes: " << estimate.tree_bytes() << "\n";
+        std::cout << "estimated_solver_bytes_" << kRangeSize << ": " << estimate.solver_bytes(kRangeSize) << "\n";
+        return 0;
+    } else if (!mapped_tree.loaded()) {
+        // Size the tree before committing memory to it; the count stops at the limit.
+        if (builder.estimate(options.max_nodes).over_limit) {
+            std::cerr << "tree would have over " << options.max_nodes << " nodes, the limit\n";
+            return 1;
+        }
+        options.progress_interval = 100000;
+        options.progress = [](const poker::TreeBuildProgress& p) {
+            std::cerr << "building tree: " << p.nodes << " nodes, " << p.edges << " edges, " << p.open_nodes
+                      << " open\n";
+        };
+        built_tree = builder.build(options);
+
+        if (!save_tree_path.empty()) {
+            try {
+                poker::write_game_tree(save_tree_path, built_tree);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+            std::cerr << "saved tree to " << save_tree_path << "\n";
+        }
+    }
+    const poker::GameTreeView tree = mapped_tree.loaded() ? mapped_tree.tree() : built_tree.view();
 
     std::array<int, 3> type_counts{0, 0, 0};
     int fold_terminal = 0;
@@ -30,7 +121,7 @@ int main() {
             type_counts[1]++;
         } else if (n.type == poker::NodeType::Terminal) {
             type_counts[2]++;
-            if (n.terminal.kind == poker::TerminalKind::Fold) {
+            if (tree.terminal_of(n).kind == poker::TerminalKind::Fold) {
                 fold_terminal++;
             } else {
                 showdown_terminal++;
@@ -38,7 +129,7 @@ int main() {
         }
     }
 
-    std::cout << "Tree build complete\n";
+    std::cout << (mapped_tree.loaded() ? "Tree load complete\n" : "Tree build complete\n");
     std::cout << "root_id: " << tree.root_id << "\n";
     std::cout << "total_nodes: " << tree.nodes.size() << "\n";
     std::cout << "decision_nodes: " << type_counts[0] << "\n";
@@ -47,5 +138,24 @@ int main() {
     std::cout << "terminal_fold: " << fold_terminal << "\n";
     std::cout << "terminal_showdown: " << showdown_terminal << "\n";
 
+    if (preflop_table) {
+        // Showdowns reached directly from a preflop decision are all-in before the flop; their
+        // equity is a table read instead of a 5-card runout enumeration.
+        int preflop_allin = 0;
+        for (const auto& n : tree.nodes) {
+            if (n.type != poker::NodeType::Decision || n.street != poker::Street::Preflop) {
+                continue;
+            }
+            for (int child : tree.children_of(n)) {
+                const auto& c = tree.nodes[static_cast<std::size_t>(child)];
+                if (c.type == poker::NodeType::Terminal && tree.terminal_of(c).kind == poker::TerminalKind::Showdown) {
+                    ++preflop_allin;
+                }
+            }
+        }
+        std::cout << "preflop_table: " << (preflop_table->exact() ? "exact" : "monte carlo") << "\n";
+        std::cout << "preflop_allin_terminals: " << preflop_allin << "\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,339 @@
+#include "poker/state_batch.hpp"
+
+#include "poker/card_set.hpp"
+#include "poker/hand_eval.hpp"
+#include "poker/rng.hpp"
+#include "poker/zobrist.hpp"
+
+#include <algorithm>
+
+namespace poker {
+
+namespace {
+
+// Amount of a pot-fraction action as Rules computes it: the raise increment (total put in
+// by the player this action) when facing a bet, otherwise the bet size.
+inline std::int32_t size_amount(std::int32_t pot, std::int32_t current_bet, std::int32_t last_bet, std::int32_t commit,
+                                bool facing, double fraction) {
+    const auto scaled = static_cast<std::int32_t>(pot * fraction);
+    const std::int32_t min_to = current_bet + std::max<std::int32_t>(1, last_bet);
+    const std::int32_t raise = std::max(min_to, current_bet + scaled) - commit;
+    const std::int32_t bet = std::max<std::int32_t>(1, scaled);
+    return facing ? raise : bet;
+}
+
+// 32-bit integer hash (lowbias32, Wellons). Policy draws hash a per-lane Weyl counter, so
+// choose() needs only 32-bit lane arithmetic.
+inline std::uint32_t hash32(std::uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+constexpr std::uint32_t kWeyl32 = 0x9e3779b9U;
+
+// Branch-free `c ? a : b`. Written as a mask blend so GCC keeps it a data dependency;
+// plain ternaries in a loop this size get turned back into branches and block
+// vectorization.
+inline std::int32_t select(bool c, std::int32_t a, std::int32_t b) {
+    const std::int32_t m = -static_cast<std::int32_t>(c);
+    return (a & m) | (b & ~m);
+}
+
+} // namespace
+
+StateBatch::StateBatch(std::size_t lanes, const RulesConfig& config)
+    : config_(config), blocks_((lanes + kBlockLanes - 1) / kBlockLanes) {
+    for (Block& b : blocks_) {
+        b = Block{};
+        b.street.fill(kTerminal);
+    }
+}
+
+void StateBatch::reset(std::size_t lane, std::uint64_t seed) {
+    Block& b = block(lane);
+    const std::size_t j = slot(lane);
+
+    SplitMix64 rng(seed);
+    CardSet used;
+    std::array<int, 9> cards{};
+    for (int& c : cards) {
+        do {
+            c = static_cast<int>(uniform_below(rng, 52));
+        } while (used.contains(c));
+        used.insert(c);
+    }
+    for (std::size_t k = 0; k < 4; ++k) {
+        b.hole[k][j] = static_cast<std::uint8_t>(cards[k]);
+    }
+    for (std::size_t k = 0; k < 5; ++k) {
+        b.board[k][j] = static_cast<std::uint8_t>(cards[4 + k]);
+    }
+    b.rng[j] = static_cast<std::uint32_t>(rng() >> 32);
+
+    // Every card is known up front, so the showdown winner is settled once here and the
+    // payoff kernel stays pure arithmetic.
+    const std::array<int, 5> board{cards[4], cards[5], cards[6], cards[7], cards[8]};
+    const int s0 = evaluate_hand({cards[0], cards[1]}, board);
+    const int s1 = evaluate_hand({cards[2], cards[3]}, board);
+    b.showdown[j] = (s0 > s1) - (s0 < s1);
+
+    const std::int32_t sb = config_.small_blind;
+    const std::int32_t bb = config_.big_blind;
+    b.stack[0][j] = config_.starting_stack - sb;
+    b.stack[1][j] = config_.starting_stack - bb;
+    b.round[0][j] = sb;
+    b.round[1][j] = bb;
+    b.total[0][j] = sb;
+    b.total[1][j] = bb;
+    b.pot[j] = sb + bb;
+    b.current_bet[j] = bb;
+    b.last_bet[j] = bb - sb;
+    b.street[j] = static_cast<std::int32_t>(Street::Preflop);
+    b.to_act[j] = 0;
+    b.folded[j] = 0;
+    b.street_actions[j] = 0;
+    b.raises[j] = 0;
+    b.actions[j] = 0;
+    b.dealt[j] = 0;
+    b.legal[j] = 0;
+}
+
+void StateBatch::retire(std::size_t lane) {
+    block(lane).street[slot(lane)] = kTerminal;
+    block(lane).legal[slot(lane)] = 0;
+}
+
+int StateBatch::winner(std::size_t lane) const {
+    const Block& b = block(lane);
+    const std::size_t j = slot(lane);
+    if (b.folded[j] != 0) {
+        return b.folded[j] == 1 ? 1 : 0;
+    }
+    return b.showdown[j] > 0 ? 0 : (b.showdown[j] < 0 ? 1 : -1);
+}
+
+void StateBatch::compute_legal() {
+    const std::int32_t max_raises = config_.max_raises_per_street;
+    const bool allow_all_in = config_.allow_all_in;
+    const double x0 = config_.bet_sizes[0];
+    const double x1 = config_.bet_sizes[1];
+    const double x2 = config_.bet_sizes[2];
+    for (Block& b : blocks_) {
+        for (std::size_t j = 0; j < kBlockLanes; ++j) {
+            const bool p1 = b.to_act[j] != 0;
+            const std::int32_t stack = select(p1, b.stack[1][j], b.stack[0][j]);
+            const std::int32_t commit = select(p1, b.round[1][j], b.round[0][j]);
+            const std::int32_t cb = b.current_bet[j];
+            const std::int32_t call = std::max<std::int32_t>(0, cb - commit);
+            const bool facing = call > 0;
+            const bool aggress = (stack > call) & (b.raises[j] < max_raises);
+            const std::int32_t floor = select(facing, call, 0);
+
+            const std::int32_t a0 = size_amount(b.pot[j], cb, b.last_bet[j], commit, facing, x0);
+            const std::int32_t a1 = size_amount(b.pot[j], cb, b.last_bet[j], commit, facing, x1);
+            const std::int32_t a2 = size_amount(b.pot[j], cb, b.last_bet[j], commit, facing, x2);
+            // Sizes that collapse onto the same amount are one action, as in Rules.
+            const bool ok0 = aggress & (a0 > floor) & (a0 < stack);
+            const bool ok1 = aggress & (a1 > floor) & (a1 < stack) & !(ok0 & (a1 == a0));
+            const bool ok2 = aggress & (a2 > floor) & (a2 < stack) & !(ok0 & (a2 == a0)) & !(ok1 & (a2 == a1));
+
+            const std::int32_t mask = static_cast<std::int32_t>(facing) | 2 | (static_cast<std::int32_t>(ok0) << 2) |
+                                      (static_cast<std::int32_t>(ok1) << 3) | (static_cast<std::int32_t>(ok2) << 4) |
+                                      (static_cast<std::int32_t>(aggress & allow_all_in) << 5);
+            b.legal[j] = select(b.street[j] == kTerminal, 0, mask);
+            b.amount[0][j] = a0;
+            b.amount[1][j] = a1;
+            b.amount[2][j] = a2;
+        }
+    }
+}
+
+void StateBatch::choose(const BatchPolicy& weights) {
+    const std::uint32_t w0 = weights[0];
+    const std::uint32_t w1 = weights[1];
+    const std::uint32_t w2 = weights[2];
+    const std::uint32_t w3 = weights[3];
+    const std::uint32_t w4 = weights[4];
+    const std::uint32_t w5 = weights[5];
+    for (Block& b : blocks_) {
+        for (std::size_t j = 0; j < kBlockLanes; ++j) {
+            const std::int32_t mask = b.legal[j];
+            const std::uint32_t counter = b.rng[j];
+            const std::uint32_t r = hash32(counter);
+            b.rng[j] = counter + (mask != 0 ? kWeyl32 : 0);
+
+            // Cumulative legal weights; the pick lands in [c_{k-1}, c_k) for choice k, so k
+            // is the number of bounds at or below it.
+            const std::uint32_t c0 = w0 * static_cast<std::uint32_t>(mask & 1);
+            const std::uint32_t c1 = c0 + w1 * static_cast<std::uint32_t>((mask >> 1) & 1);
+            const std::uint32_t c2 = c1 + w2 * static_cast<std::uint32_t>((mask >> 2) & 1);
+            const std::uint32_t c3 = c2 + w3 * static_cast<std::uint32_t>((mask >> 3) & 1);
+            const std::uint32_t c4 = c3 + w4 * static_cast<std::uint32_t>((mask >> 4) & 1);
+            const std::uint32_t total = c4 + w5 * static_cast<std::uint32_t>((mask >> 5) & 1);
+            const auto pick = static_cast<std::uint32_t>((static_cast<std::uint64_t>(r) * total) >> 32);
+            const std::int32_t k = static_cast<std::int32_t>(pick >= c0) + static_cast<std::int32_t>(pick >= c1) +
+                                   static_cast<std::int32_t>(pick >= c2) + static_cast<std::int32_t>(pick >= c3) +
+                                   static_cast<std::int32_t>(pick >= c4);
+            const std::int32_t chosen = select(total == 0, static_cast<std::int32_t>(BatchAction::CheckCall), k);
+            b.choice[j] = select(mask != 0, chosen, b.choice[j]);
+        }
+    }
+}
+
+void StateBatch::apply() {
+    for (Block& b : blocks_) {
+        for (std::size_t j = 0; j < kBlockLanes; ++j) {
+            const std::int32_t st = b.street[j];
+            const std::int32_t k = b.choice[j];
+            const std::int32_t player = b.to_act[j];
+            const std::int32_t s0 = b.stack[0][j];
+            const std::int32_t s1 = b.stack[1][j];
+            const std::int32_t r0 = b.round[0][j];
+            const std::int32_t r1 = b.round[1][j];
+            const std::int32_t cb = b.current_bet[j];
+            const std::int32_t lb = b.last_bet[j];
+            const std::int32_t on_street = b.street_actions[j];
+            const std::int32_t raises = b.raises[j];
+            const bool live = st != kTerminal;
+            const bool p1 = player != 0;
+            const std::int32_t stack = select(p1, s1, s0);
+            const std::int32_t commit = select(p1, r1, r0);
+            const std::int32_t call = std::max<std::int32_t>(0, cb - commit);
+
+            // Terminal lanes take no action: every flag below is false and nothing is put in.
+            const bool fold = live & (k == static_cast<std::int32_t>(BatchAction::Fold));
+            const bool passive = live & (k == static_cast<std::int32_t>(BatchAction::CheckCall));
+            const bool aggressive = live & (k >= static_cast<std::int32_t>(BatchAction::Size0));
+            std::int32_t put = b.amount[2][j];
+            put = select(k == static_cast<std::int32_t>(BatchAction::Size1), b.amount[1][j], put);
+            put = select(k == static_cast<std::int32_t>(BatchAction::Size0), b.amount[0][j], put);
+            put = select(k == static_cast<std::int32_t>(BatchAction::AllIn), stack, put);
+            put = select(passive, call, put);
+            put = select(passive | aggressive, std::min(put, stack), 0);
+
+            const std::int32_t put0 = select(p1, 0, put);
+            const std::int32_t put1 = put - put0;
+            const std::int32_t ns0 = s0 - put0;
+            const std::int32_t ns1 = s1 - put1;
+            const std::int32_t nr0 = r0 + put0;
+            const std::int32_t nr1 = r1 + put1;
+            const std::int32_t ncb = select(aggressive, std::max(cb, commit + put), cb);
+            const std::int32_t nlb = select(aggressive, std::max<std::int32_t>(1, ncb - cb), lb);
+
+            const bool forced_showdown = (passive | aggressive) & ((ns0 == 0) | (ns1 == 0));
+            // The round closes on a check or call that matches the bet once both players have
+            // acted, i.e. when it is not the first action of the street.
+            const bool advance = passive & !forced_showdown & (nr0 == nr1) & (on_street > 0);
+            const bool river_done = advance & (st == static_cast<std::int32_t>(Street::River));
+            const bool terminal = fold | forced_showdown | river_done;
+            const bool next_street = advance & !river_done;
+            // A closed round, an all-in showdown or a fold clears the betting fields. The
+            // action passes to player 0 on a new street or at a showdown, otherwise to the
+            // opponent.
+            const bool to_p0 = advance | forced_showdown;
+            const bool clear = to_p0 | fold;
+            // Board cards shown: 3/4/5 after each street advance, all five at any showdown.
+            std::int32_t shown = select(next_street, select(st == 0, 3, st + 3), b.dealt[j]);
+            shown = select(forced_showdown | river_done, 5, shown);
+
+            b.stack[0][j] = ns0;
+            b.stack[1][j] = ns1;
+            b.total[0][j] += put0;
+            b.total[1][j] += put1;
+            b.pot[j] += put;
+            b.round[0][j] = select(clear, 0, nr0);
+            b.round[1][j] = select(clear, 0, nr1);
+            b.current_bet[j] = select(clear, 0, ncb);
+            b.last_bet[j] = select(clear, 0, nlb);
+            b.folded[j] |= select(fold, select(p1, 2, 1), 0);
+            b.street[j] = select(terminal, kTerminal, st + static_cast<std::int32_t>(next_street));
+            b.to_act[j] = select(live, select(to_p0 | p1, 0, 1), player);
+            b.street_actions[j] = select(live, select(next_street, 0, on_street + 1), on_street);
+            b.raises[j] = select(advance, 0, raises + static_cast<std::int32_t>(aggressive));
+            b.actions[j] += static_cast<std::int32_t>(live);
+            b.dealt[j] = shown;
+        }
+    }
+}
+
+void StateBatch::payoffs(std::int32_t* p0_delta) const {
+    for (const Block& b : blocks_) {
+        for (std::size_t j = 0; j < kBlockLanes; ++j) {
+            const std::int32_t f = b.folded[j];
+            const std::int32_t sd = b.showdown[j];
+            const std::int32_t pot = b.pot[j];
+            const bool win = (f == 2) | ((f == 0) & (sd > 0));
+            const bool tie = (f == 0) & (sd == 0);
+            const std::int32_t payout = select(win, pot, select(tie, pot / 2, 0));
+            p0_delta[j] = select(b.street[j] == kTerminal, payout - b.total[0][j], 0);
+        }
+        p0_delta += kBlockLanes;
+    }
+}
+
+Action StateBatch::action(std::size_t lane, BatchAction a) const {
+    const Block& b = block(lane);
+    const std::size_t j = slot(lane);
+    const int p = b.to_act[j];
+    const std::int32_t stack = b.stack[static_cast<std::size_t>(p)][j];
+    const std::int32_t commit = b.round[static_cast<std::size_t>(p)][j];
+    const std::int32_t cb = b.current_bet[j];
+    const std::int32_t call = std::max<std::int32_t>(0, cb - commit);
+    const bool facing = call > 0;
+    const auto street = static_cast<Street>(b.street[j]);
+
+    switch (a) {
+        case BatchAction::Fold:
+            return Action{p, ActionType::Fold, 0, call, street};
+        case BatchAction::CheckCall:
+            return facing ? Action{p, ActionType::Call, std::min(call, stack), call, street}
+                          : Action{p, ActionType::Check, 0, 0, street};
+        case BatchAction::AllIn:
+            return Action{p, facing ? ActionType::Raise : ActionType::Bet, stack, call, street};
+        case BatchAction::Size0:
+        case BatchAction::Size1:
+        case BatchAction::Size2: {
+            const double fraction = config_.bet_sizes[static_cast<std::size_t>(a) - 2];
+            const std::int32_t amount = size_amount(b.pot[j], cb, b.last_bet[j], commit, facing, fraction);
+            return Action{p, facing ? ActionType::Raise : ActionType::Bet, amount, call, street};
+        }
+    }
+    return Action{};
+}
+
+State StateBatch::state(std::size_t lane) const {
+    const Block& b = block(lane);
+    const std::size_t j = slot(lane);
+    State s;
+    s.street = static_cast<Street>(b.street[j]);
+    s.pot = b.pot[j];
+    s.to_act = b.to_act[j];
+    s.current_bet = b.current_bet[j];
+    s.last_bet_size = b.last_bet[j];
+    for (std::size_t p = 0; p < 2; ++p) {
+        s.stacks[p] = b.stack[p][j];
+        s.committed_this_round[p] = b.round[p][j];
+        s.committed_total[p] = b.total[p][j];
+        s.folded[p] = ((b.folded[j] >> p) & 1) != 0;
+        s.hole_cards[p] = {b.hole[2 * p][j], b.hole[2 * p + 1][j]};
+        s.used_cards |= CardSet::of(s.hole_cards[p]);
+    }
+    s.bet_to_call = std::max(0, s.current_bet - s.committed_this_round[static_cast<std::size_t>(s.to_act)]);
+    s.raises_this_street = b.raises[j];
+    // Between actions only the player who acted last has acted since the last bet.
+    if (b.street[j] != kTerminal && b.street_actions[j] > 0) {
+        s.acted_this_round[static_cast<std::size_t>(1 - s.to_act)] = true;
+    }
+    for (std::size_t k = 0; k < static_cast<std::size_t>(b.dealt[j]); ++k) {
+        s.board.push_back(b.board[k][j]);
+        s.used_cards.insert(b.board[k][j]);
+    }
+    s.hash = zobrist::hash(s);
+    return s;
+}
+
+} // namespace poker
@@ -1,124 +1,333 @@
 #include "poker/tree.hpp"
 
+#include "tree_builder_parallel.hpp"
+#include "tree_memo.hpp"
 #include "tree_state_logic.hpp"
 
+#include <algorithm>
 #include <stdexcept>
-#include <unordered_map>
+#include <thread>
+#include <utility>
 
 namespace poker {
 
 namespace {
 
+// Depth-first construction on an explicit stack, so depth is bounded by memory rather
+// than the call stack. A node gets its id and its edge range when it is first reached and
+// edges are expanded in action order, so ids are numbered in preorder.
 struct BuildContext {
+    // A Decision or Chance node whose edges are still being expanded.
+    struct Frame {
+        TreeState state;
+        int id = -1;
+        std::uint32_t next = 0; // next edge to expand, relative to first_child
+    };
+
     const BettingAbstraction& ab;
-    std::size_t max_nodes;
+    TreeBuilder::ActionGenerator generate;
+    const TreeBuildOptions& options;
 
     GameTree tree;
-    std::unordered_map<std::string, int> memo;
+    detail::NodeMemo memo;
+    std::vector<Frame> stack;
+    std::size_t next_report = 0;
 
-    int make_node(const TreeNode& n) {
-        if (tree.nodes.size() >= max_nodes) {
-            throw std::runtime_error("tree build exceeded max_nodes; refine abstraction or increase limit");
+    void build(const TreeState& root) {
+        next_report = options.progress_interval;
+        tree.root_id = reach(root);
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            const TreeNode& n = tree.nodes[static_cast<std::size_t>(f.id)];
+            if (f.next == n.child_count) {
+                stack.pop_back();
+                continue;
+            }
+            const std::size_t edge = n.first_child + f.next;
+            const std::size_t i = f.next++;
+            // reach() may grow the stack and the tree, so f and n are not used past here.
+            int child = -1;
+            if (n.type == NodeType::Chance) {
+                const TreeState s = f.state;
+                child = reach(s);
+            } else {
+                const detail::Transition t = detail::apply_action(f.state, tree.action(n, i));
+                if (t.is_terminal) {
+                    child = reach(t.state, NodeType::Terminal, t.terminal_kind);
+                } else if (t.via_chance) {
+                    child = reach(t.state, NodeType::Chance);
+                } else {
+                    child = reach(t.state);
+                }
+            }
+            tree.children[edge] = child;
         }
-        tree.nodes.push_back(n);
-        return n.id;
+        report();
+    }
+
+    // Id of the Decision or Terminal node of a state reached by a deal or a non-closing action.
+    int reach(const TreeState& s) {
+        if (s.street == Street::Terminal) {
+            const TerminalKind kind = (s.folded[0] || s.folded[1]) ? TerminalKind::Fold : TerminalKind::Showdown;
+            return reach(s, NodeType::Terminal, kind);
+        }
+        return reach(s, NodeType::Decision);
     }
 
-    int build_terminal(const TreeState& s, TerminalKind kind) {
-        const std::string key = std::string("T:") + (kind == TerminalKind::Fold ? "F:" : "S:") + detail::state_key(s);
-        auto it = memo.find(key);
-        if (it != memo.end()) {
-            return it->second;
+    // Id of the node (s, type), created if new; new Decision and Chance nodes are pushed for
+    // expansion.
+    int reach(const TreeState& s, NodeType type, TerminalKind kind = TerminalKind::Showdown) {
+        const detail::NodeKey key = detail::node_key(s, type);
+        const std::uint64_t hash = detail::node_hash(s, type);
+        const int found = memo.find(key, hash);
+        if (found >= 0) {
+            return found;
         }
 
-        TreeNode n;
-        n.id = static_cast<int>(tree.nodes.size());
-        n.type = NodeType::Terminal;
-        n.key = key;
-        n.state = s;
-        n.terminal = detail::terminal_from_state(s, kind);
-
-        const int id = make_node(n);
-        memo.emplace(key, id);
+        const int id = add(s, type, key, hash);
+        switch (type) {
+            case NodeType::Terminal:
+                tree.nodes.back().terminal = static_cast<std::int32_t>(tree.terminals.size());
+                tree.terminals.push_back(detail::terminal_from_state(s, kind));
+                return id;
+            case NodeType::Chance:
+                add_edges(id, 1);
+                break;
+            case NodeType::Decision: {
+                ActionBuffer actions;
+                detail::node_actions(s, ab, generate, actions);
+                const std::size_t first = add_edges(id, actions.size());
+                if (!actions.empty()) {
+                    // Every action of a state carries the same call amount.
+                    tree.nodes.back().to_call = actions[0].to_call_before;
+                }
+                for (std::size_t i = 0; i < actions.size(); ++i) {
+                    tree.actions[first + i] = TreeAction{actions[i].amount, actions[i].type};
+                }
+                break;
+            }
+        }
+        stack.push_back(Frame{s, id, 0});
         return id;
     }
 
-    int build_chance(const TreeState& s) {
-        const std::string key = "C:" + detail::state_key(s);
-        auto it = memo.find(key);
-        if (it != memo.end()) {
-            return it->second;
+    int add(const TreeState& s, NodeType type, const detail::NodeKey& key, std::uint64_t hash) {
+        if (tree.nodes.size() >= options.max_nodes) {
+            throw std::runtime_error("tree build exceeded max_nodes; refine abstraction or increase limit");
         }
+        const int id = static_cast<int>(tree.nodes.size());
+        memo.insert(key, hash, id);
 
         TreeNode n;
-        n.id = static_cast<int>(tree.nodes.size());
-        n.type = NodeType::Chance;
-        n.key = key;
-        n.state = s;
-
-        const int id = make_node(n);
-        memo.emplace(key, id);
-
-        const int child = build_decision_or_terminal(s);
-        tree.nodes[static_cast<std::size_t>(id)].children.push_back(child);
+        n.type = type;
+        n.player = static_cast<std::uint8_t>(s.to_act);
+        n.street = s.street;
+        tree.nodes.push_back(n);
+        if (options.keep_states) {
+            tree.states.push_back(s);
+        }
+        if (tree.nodes.size() == next_report) {
+            report();
+            next_report += options.progress_interval;
+        }
         return id;
     }
 
-    int build_decision_or_terminal(const TreeState& s) {
-        if (s.street == Street::Terminal) {
-            const TerminalKind kind = (s.folded[0] || s.folded[1]) ? TerminalKind::Fold : TerminalKind::Showdown;
-            return build_terminal(s, kind);
-        }
+    // Appends `count` edges for node `id`, to be filled as its children are reached.
+    std::size_t add_edges(int id, std::size_t count) {
+        const std::size_t first = tree.children.size();
+        TreeNode& n = tree.nodes[static_cast<std::size_t>(id)];
+        n.first_child = static_cast<std::uint32_t>(first);
+        n.child_count = static_cast<std::uint8_t>(count);
+        tree.actions.resize(first + count);
+        tree.children.resize(first + count, -1);
+        return first;
+    }
 
-        const std::string key = "D:" + detail::state_key(s);
-        auto it = memo.find(key);
-        if (it != memo.end()) {
-            return it->second;
+    void report() const {
+        if (options.progress) {
+            options.progress(TreeBuildProgress{tree.nodes.size(), tree.children.size(), stack.size()});
         }
+    }
+};
 
-        TreeNode n;
-        n.id = static_cast<int>(tree.nodes.size());
-        n.type = NodeType::Decision;
-        n.key = key;
-        n.state = s;
+// The traversal of BuildContext, counting nodes instead of storing them. A frame keeps its
+// node's actions, as there is no tree to read them back from.
+struct EstimateContext {
+    struct Frame {
+        TreeState state;
+        ActionBuffer actions; // empty for a Chance node
+        std::size_t next = 0;
+        std::size_t edges = 0;
+    };
 
-        const int id = make_node(n);
-        memo.emplace(key, id);
+    const BettingAbstraction& ab;
+    TreeBuilder::ActionGenerator generate;
+    std::size_t max_nodes; // at most kMaxTreeNodes, so memo ids fit an int
 
-        auto actions = detail::legal_actions(s, ab);
-        for (const auto& a : actions) {
-            detail::Transition t = detail::apply_action(s, a);
-            int child = -1;
+    TreeEstimate estimate;
+    detail::NodeMemo memo;
+    std::vector<Frame> stack;
+
+    void run(const TreeState& root) {
+        reach(root);
+        while (!stack.empty() && !estimate.over_limit) {
+            Frame& f = stack.back();
+            if (f.next == f.edges) {
+                stack.pop_back();
+                continue;
+            }
+            if (f.actions.empty()) {
+                const TreeState s = f.state;
+                ++f.next;
+                reach(s);
+                continue;
+            }
+            const detail::Transition t = detail::apply_action(f.state, f.actions[f.next++]);
             if (t.is_terminal) {
-                child = build_terminal(t.state, t.terminal_kind);
+                reach(t.state, NodeType::Terminal);
             } else if (t.via_chance) {
-                child = build_chance(t.state);
+                reach(t.state, NodeType::Chance);
             } else {
-                child = build_decision_or_terminal(t.state);
+                reach(t.state);
             }
-            tree.nodes[static_cast<std::size_t>(id)].actions.push_back(a);
-            tree.nodes[static_cast<std::size_t>(id)].children.push_back(child);
         }
+    }
 
-        return id;
+    void reach(const TreeState& s) {
+        reach(s, s.street == Street::Terminal ? NodeType::Terminal : NodeType::Decision);
+    }
+
+    void reach(const TreeState& s, NodeType type) {
+        const detail::NodeKey key = detail::node_key(s, type);
+        const std::uint64_t hash = detail::node_hash(s, type);
+        if (memo.find(key, hash) >= 0) {
+            return;
+        }
+        if (memo.size() == max_nodes) {
+            estimate.over_limit = true;
+            return;
+        }
+        memo.insert(key, hash, static_cast<int>(memo.size()));
+        ++estimate.nodes[static_cast<std::size_t>(s.street)][static_cast<std::size_t>(type)];
+
+        Frame f{s, {}, 0, 0};
+        switch (type) {
+            case NodeType::Terminal:
+                return;
+            case NodeType::Chance:
+                f.edges = 1;
+                break;
+            case NodeType::Decision:
+                detail::node_actions(s, ab, generate, f.actions);
+                f.edges = f.actions.size();
+                estimate.decision_edges += f.edges;
+                break;
+        }
+        estimate.edges += f.edges;
+        stack.push_back(std::move(f));
     }
 };
 
 } // namespace
 
-TreeBuilder::TreeBuilder(BettingAbstraction abstraction) : abstraction_(std::move(abstraction)) {}
+std::size_t TreeEstimate::count(NodeType type) const {
+    std::size_t n = 0;
+    for (const auto& by_type : nodes) {
+        n += by_type[static_cast<std::size_t>(type)];
+    }
+    return n;
+}
+
+std::size_t TreeEstimate::total_nodes() const {
+    return count(NodeType::Decision) + count(NodeType::Chance) + count(NodeType::Terminal);
+}
+
+std::size_t TreeEstimate::tree_bytes() const {
+    return total_nodes() * sizeof(TreeNode) + edges * (sizeof(TreeAction) + sizeof(std::int32_t)) +
+           count(NodeType::Terminal) * sizeof(TerminalData);
+}
+
+std::size_t TreeEstimate::solver_bytes(std::size_t range_size) const {
+    return 2 * decision_edges * range_size * sizeof(float);
+}
+
+TreeBuilder::TreeBuilder(BettingAbstraction abstraction) : abstraction_(std::move(abstraction)) {
+    // Fold/check, call and all-in plus the sizes must fit one ActionBuffer.
+    for (std::size_t si = 0; si < 4; ++si) {
+        if (abstraction_.bet_sizes_by_street[si].size() + 3 > kMaxActions ||
+            abstraction_.raise_sizes_by_street[si].size() + 3 > kMaxActions) {
+            throw std::invalid_argument("too many bet or raise sizes on one street");
+        }
+    }
+}
+
+TreeBuilder::TreeBuilder(BettingAbstraction abstraction, ActionGenerator generate)
+    : TreeBuilder(std::move(abstraction)) {
+    generate_ = generate;
+}
 
 GameTree TreeBuilder::build(std::size_t max_nodes) const {
-    BuildContext ctx{abstraction_, max_nodes, GameTree{}, {}};
-    TreeState root = detail::initial_state(abstraction_);
-    ctx.tree.root_id = ctx.build_decision_or_terminal(root);
+    TreeBuildOptions options;
+    options.max_nodes = max_nodes;
+    return build(options);
+}
+
+GameTree TreeBuilder::build(const TreeBuildOptions& options) const {
+    const int threads = options.threads > 0 ? options.threads
+                                            : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (threads > 1) {
+        return detail::build_parallel(abstraction_, generate_, options, threads);
+    }
+
+    // Sized for small trees; the memo grows with the build.
+    detail::NodeMemo memo(std::min<std::size_t>(options.max_nodes, 4096));
+    BuildContext ctx{abstraction_, generate_, options, GameTree{}, std::move(memo), {}, 0};
+    ctx.build(detail::initial_state(abstraction_));
+
+    GameTree& tree = ctx.tree;
+    tree.nodes.shrink_to_fit();
+    tree.actions.shrink_to_fit();
+    tree.children.shrink_to_fit();
+    tree.terminals.shrink_to_fit();
+    tree.states.shrink_to_fit();
     return std::move(ctx.tree);
 }
 
+TreeEstimate TreeBuilder::estimate(std::size_t max_nodes) const {
+    max_nodes = std::min(max_nodes, kMaxTreeNodes);
+    detail::NodeMemo memo(std::min<std::size_t>(max_nodes, 4096));
+    EstimateContext ctx{abstraction_, generate_, max_nodes, TreeEstimate{}, std::move(memo), {}};
+    ctx.run(detail::initial_state(abstraction_));
+    return ctx.estimate;
+}
+
+TreeEstimate TreeBuilder::estimate(const BettingAbstraction& abstraction, std::size_t max_nodes) {
+    return TreeBuilder(abstraction).estimate(max_nodes);
+}
+
 BettingAbstraction TreeBuilder::default_abstraction() {
     return BettingAbstraction{};
 }
 
+std::string debug_key(const GameTree& tree, int id) {
+    const auto i = static_cast<std::size_t>(id);
+    if (i >= tree.states.size()) {
+        throw std::invalid_argument("debug_key needs a tree built with keep_states");
+    }
+    const TreeNode& n = tree.nodes[i];
+    const std::string state = detail::state_key(tree.states[i]);
+    switch (n.type) {
+        case NodeType::Decision:
+            return "D:" + state;
+        case NodeType::Chance:
+            return "C:" + state;
+        case NodeType::Terminal:
+            return (tree.terminal_of(n).kind == TerminalKind::Fold ? "T:F:" : "T:S:") + state;
+    }
+    return state;
+}
+
 std::string to_string(NodeType t) {
     switch (t) {
         case NodeType::Decision:
@@ -0,0 +1,385 @@
+#include "tree_builder_parallel.hpp"
+
+#include "tree_memo.hpp"
+#include "tree_state_logic.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace poker::detail {
+
+namespace {
+
+// A node during the build: the worker that created it and its index in that worker's
+// arrays. Ids are only assigned once every node exists.
+using NodeRef = std::uint64_t;
+
+constexpr int kMaxWorkers = 256;
+constexpr NodeRef kNoNode = ~NodeRef{0};
+// Workers publish their node and edge counts in batches of this many nodes.
+constexpr std::size_t kCountBatch = 4096;
+
+NodeRef make_ref(std::size_t worker, std::size_t index) {
+    return static_cast<NodeRef>(index) << 8 | worker;
+}
+
+std::size_t worker_of(NodeRef r) {
+    return static_cast<std::size_t>(r & 0xff);
+}
+
+std::size_t index_of(NodeRef r) {
+    return static_cast<std::size_t>(r >> 8);
+}
+
+// The subtree below a chance node: the state after the deal and the chance node itself
+// (kNoNode for the root).
+struct Task {
+    TreeState state;
+    NodeRef chance = kNoNode;
+};
+
+// Nodes created by one worker, laid out as in GameTree but with edges to NodeRefs.
+struct Worker {
+    std::vector<TreeNode> nodes;
+    std::vector<TreeAction> actions;
+    std::vector<NodeRef> children;
+    std::vector<TerminalData> terminals;
+    std::vector<TreeState> states;
+    // The child of each chance node whose task this worker ran; the edge belongs to the
+    // chance node's creator, so it is filled in after the build.
+    std::vector<std::pair<NodeRef, NodeRef>> chance_children;
+
+    // Owner pushes and pops at the back; thieves take from the front.
+    std::mutex mutex;
+    std::deque<Task> tasks;
+
+    std::size_t unpublished_nodes = 0;
+    std::size_t unpublished_edges = 0;
+};
+
+struct ParallelBuild {
+    struct Frame {
+        TreeState state;
+        std::size_t index = 0; // into the worker's nodes
+        std::uint32_t next = 0;
+    };
+
+    const BettingAbstraction& ab;
+    TreeBuilder::ActionGenerator generate;
+    const TreeBuildOptions& options;
+
+    SharedNodeMemo memo;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<std::size_t> nodes{0};
+    std::atomic<std::size_t> edges{0};
+    std::atomic<std::size_t> pending{0}; // tasks queued or running
+    std::atomic<bool> failed{false};
+    NodeRef root = kNoNode;
+    std::exception_ptr error;
+    std::mutex mutex; // guards error and progress calls
+
+    ParallelBuild(const BettingAbstraction& abstraction, TreeBuilder::ActionGenerator gen,
+                  const TreeBuildOptions& opts, int threads)
+        : ab(abstraction), generate(gen), options(opts), memo(std::min<std::size_t>(opts.max_nodes, 4096)) {
+        for (int t = 0; t < threads; ++t) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    void run(std::size_t w) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            Task task;
+            if (!take(w, task)) {
+                if (pending.load() == 0) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            try {
+                expand(w, task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+            pending.fetch_sub(1);
+        }
+    }
+
+    bool take(std::size_t w, Task& task) {
+        {
+            Worker& own = *workers[w];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < workers.size(); ++i) {
+            Worker& victim = *workers[(w + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Depth-first expansion of one subtree as in the serial builder, except that new chance
+    // nodes are queued as tasks instead of being descended into.
+    void expand(std::size_t w, const Task& task) {
+        Worker& me = *workers[w];
+        std::vector<Frame> stack;
+        const NodeRef top = reach(w, task.state, stack);
+        if (task.chance != kNoNode) {
+            me.chance_children.emplace_back(task.chance, top);
+        } else {
+            root = top;
+        }
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            const TreeNode n = me.nodes[f.index];
+            if (f.next == n.child_count) {
+                stack.pop_back();
+                continue;
+            }
+            const std::size_t edge = n.first_child + f.next;
+            const Action a = Action{n.player, me.actions[edge].type, me.actions[edge].amount, n.to_call, n.street};
+            ++f.next;
+            const Transition t = apply_action(f.state, a);
+            NodeRef child = kNoNode;
+            if (t.is_terminal) {
+                child = reach(w, t.state, NodeType::Terminal, t.terminal_kind, stack);
+            } else if (t.via_chance) {
+                child = reach(w, t.state, NodeType::Chance, TerminalKind::Showdown, stack);
+            } else {
+                child = reach(w, t.state, stack);
+            }
+            me.children[edge] = child;
+        }
+    }
+
+    NodeRef reach(std::size_t w, const TreeState& s, std::vector<Frame>& stack) {
+        if (s.street == Street::Terminal) {
+            const TerminalKind kind = (s.folded[0] || s.folded[1]) ? TerminalKind::Fold : TerminalKind::Showdown;
+            return reach(w, s, NodeType::Terminal, kind, stack);
+        }
+        return reach(w, s, NodeType::Decision, TerminalKind::Showdown, stack);
+    }
+
+    NodeRef reach(std::size_t w, const TreeState& s, NodeType type, TerminalKind kind, std::vector<Frame>& stack) {
+        Worker& me = *workers[w];
+        const NodeKey key = node_key(s, type);
+        const std::uint64_t hash = node_hash(s, type);
+        const std::size_t index = me.nodes.size();
+        bool inserted = false;
+        const NodeRef ref = memo.find_or_insert(key, hash, make_ref(w, index), inserted);
+        if (!inserted) {
+            return ref;
+        }
+
+        TreeNode n;
+        n.type = type;
+        n.player = static_cast<std::uint8_t>(s.to_act);
+        n.street = s.street;
+        if (type != NodeType::Terminal) {
+            n.first_child = static_cast<std::uint32_t>(me.children.size());
+        }
+        switch (type) {
+            case NodeType::Terminal:
+                n.terminal = static_cast<std::int32_t>(me.terminals.size());
+                me.terminals.push_back(terminal_from_state(s, kind));
+                break;
+            case NodeType::Chance:
+                n.child_count = 1;
+                me.actions.emplace_back();
+                me.children.push_back(kNoNode);
+                break;
+            case NodeType::Decision: {
+                ActionBuffer actions;
+                node_actions(s, ab, generate, actions);
+                n.child_count = static_cast<std::uint8_t>(actions.size());
+                if (!actions.empty()) {
+                    n.to_call = actions[0].to_call_before;
+                }
+                for (const Action& a : actions) {
+                    me.actions.push_back(TreeAction{a.amount, a.type});
+                }
+                me.children.resize(me.children.size() + actions.size(), kNoNode);
+                break;
+            }
+        }
+        me.nodes.push_back(n);
+        if (options.keep_states) {
+            me.states.push_back(s);
+        }
+
+        if (type == NodeType::Chance) {
+            pending.fetch_add(1);
+            std::lock_guard<std::mutex> lock(me.mutex);
+            me.tasks.push_back(Task{s, ref});
+        } else if (type == NodeType::Decision) {
+            stack.push_back(Frame{s, index, 0});
+        }
+
+        ++me.unpublished_nodes;
+        me.unpublished_edges += n.child_count;
+        if (me.unpublished_nodes == kCountBatch) {
+            publish(me);
+        }
+        return ref;
+    }
+
+    // Adds a worker's new nodes and edges to the shared counts, failing the build past
+    // max_nodes (exactly checked once the build is done) and reporting progress.
+    void publish(Worker& me) {
+        const std::size_t before = nodes.fetch_add(me.unpublished_nodes);
+        const std::size_t after = before + me.unpublished_nodes;
+        const std::size_t edge_total = edges.fetch_add(me.unpublished_edges) + me.unpublished_edges;
+        me.unpublished_nodes = 0;
+        me.unpublished_edges = 0;
+        if (after > options.max_nodes) {
+            throw std::runtime_error("tree build exceeded max_nodes; refine abstraction or increase limit");
+        }
+        const std::size_t interval = options.progress_interval;
+        if (options.progress && interval > 0 && before / interval != after / interval) {
+            std::lock_guard<std::mutex> lock(mutex);
+            options.progress(TreeBuildProgress{after, edge_total, pending.load()});
+        }
+    }
+
+    // Numbers the nodes in the order the serial builder creates them, a preorder walk
+    // taking edges in action order, and lays them out as it would.
+    GameTree assemble() {
+        for (auto& worker : workers) {
+            for (const auto& [chance, child] : worker->chance_children) {
+                Worker& owner = *workers[worker_of(chance)];
+                owner.children[owner.nodes[index_of(chance)].first_child] = child;
+            }
+        }
+
+        std::vector<std::vector<std::int32_t>> ids(workers.size());
+        std::size_t total_nodes = 0;
+        std::size_t total_edges = 0;
+        std::size_t total_terminals = 0;
+        for (std::size_t w = 0; w < workers.size(); ++w) {
+            ids[w].assign(workers[w]->nodes.size(), -1);
+            total_nodes += workers[w]->nodes.size();
+            total_edges += workers[w]->children.size();
+            total_terminals += workers[w]->terminals.size();
+        }
+        if (total_nodes > options.max_nodes) {
+            throw std::runtime_error("tree build exceeded max_nodes; refine abstraction or increase limit");
+        }
+
+        std::vector<NodeRef> order;
+        order.reserve(total_nodes);
+        const auto number = [&](NodeRef r) {
+            std::int32_t& id = ids[worker_of(r)][index_of(r)];
+            const bool is_new = id < 0;
+            if (is_new) {
+                id = static_cast<std::int32_t>(order.size());
+                order.push_back(r);
+            }
+            return is_new;
+        };
+        std::vector<std::pair<NodeRef, std::uint32_t>> stack;
+        number(root);
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            auto& [r, next] = stack.back();
+            const Worker& owner = *workers[worker_of(r)];
+            const TreeNode& n = owner.nodes[index_of(r)];
+            if (next == n.child_count) {
+                stack.pop_back();
+                continue;
+            }
+            const NodeRef child = owner.children[n.first_child + next++];
+            if (number(child)) {
+                stack.emplace_back(child, 0);
+            }
+        }
+
+        GameTree tree;
+        tree.root_id = 0;
+        tree.nodes.reserve(total_nodes);
+        tree.actions.reserve(total_edges);
+        tree.children.reserve(total_edges);
+        tree.terminals.reserve(total_terminals);
+        if (options.keep_states) {
+            tree.states.reserve(total_nodes);
+        }
+        for (NodeRef r : order) {
+            const Worker& owner = *workers[worker_of(r)];
+            const std::size_t index = index_of(r);
+            TreeNode n = owner.nodes[index];
+            const std::size_t first = n.first_child;
+            if (n.type != NodeType::Terminal) {
+                n.first_child = static_cast<std::uint32_t>(tree.children.size());
+            }
+            for (std::size_t e = first; e < first + n.child_count; ++e) {
+                const NodeRef child = owner.children[e];
+                tree.actions.push_back(owner.actions[e]);
+                tree.children.push_back(ids[worker_of(child)][index_of(child)]);
+            }
+            if (n.type == NodeType::Terminal) {
+                const std::size_t t = static_cast<std::size_t>(n.terminal);
+                n.terminal = static_cast<std::int32_t>(tree.terminals.size());
+                tree.terminals.push_back(owner.terminals[t]);
+            }
+            tree.nodes.push_back(n);
+            if (options.keep_states) {
+                tree.states.push_back(owner.states[index]);
+            }
+        }
+        return tree;
+    }
+};
+
+} // namespace
+
+GameTree build_parallel(const BettingAbstraction& ab, TreeBuilder::ActionGenerator generate,
+                        const TreeBuildOptions& options, int threads) {
+    threads = std::clamp(threads, 1, kMaxWorkers);
+    ParallelBuild build(ab, generate, options, threads);
+
+    // The root's subtree up to the first deals is one task; every chance node adds another.
+    const TreeState root = initial_state(ab);
+    build.pending = 1;
+    build.workers[0]->tasks.push_back(Task{root, kNoNode});
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<std::size_t>(threads - 1));
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back([&build, t] { build.run(static_cast<std::size_t>(t)); });
+    }
+    build.run(0);
+    for (auto& th : pool) {
+        th.join();
+    }
+    if (build.error) {
+        std::rethrow_exception(build.error);
+    }
+
+    GameTree tree = build.assemble();
+    if (options.progress) {
+        options.progress(TreeBuildProgress{tree.nodes.size(), tree.children.size(), 0});
+    }
+    return tree;
+}
+
+} // namespace poker::detail
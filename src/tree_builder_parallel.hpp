@@ -0,0 +1,11 @@
+#pragma once
+
+#include "poker/tree.hpp"
+
+namespace poker::detail {
+
+// The tree TreeBuilder builds serially, node for node, expanded by `threads` workers.
+GameTree build_parallel(const BettingAbstraction& ab, TreeBuilder::ActionGenerator generate,
+                        const TreeBuildOptions& options, int threads);
+
+} // namespace poker::detail
@@ -0,0 +1,222 @@
+#include "poker/tree_file.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace poker {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'K', 'G', 'T', 'R', 'E', 'E', '\0'};
+
+static_assert(std::is_trivially_copyable_v<TreeNode> && std::is_trivially_copyable_v<TreeAction> &&
+                  std::is_trivially_copyable_v<TerminalData>,
+              "tree file arrays are mapped in place");
+static_assert(sizeof(TreeFileHeader) % 8 == 0, "sections start 8-byte aligned");
+
+std::size_t padded(std::size_t bytes) {
+    return (bytes + 7) / 8 * 8;
+}
+
+// FNV-1a taking a 64-bit word per step instead of a byte, so checking a large file runs
+// at memory speed. `size` is a multiple of 8.
+std::uint64_t fnv1a64_words(const unsigned char* data, std::size_t size, std::uint64_t h = 0xcbf29ce484222325ULL) {
+    for (std::size_t i = 0; i < size; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h ^= w;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Record writers into a zeroed buffer. Records with padding are copied field by field so
+// that the padding stays zero and a tree always writes the same bytes.
+template <typename F>
+void put_field(unsigned char* dst, std::size_t offset, const F& field) {
+    std::memcpy(dst + offset, &field, sizeof(field));
+}
+
+void put_record(unsigned char* dst, const TreeAction& a) {
+    put_field(dst, offsetof(TreeAction, amount), a.amount);
+    put_field(dst, offsetof(TreeAction, type), a.type);
+}
+
+void put_record(unsigned char* dst, const TerminalData& t) {
+    put_field(dst, offsetof(TerminalData, kind), t.kind);
+    put_field(dst, offsetof(TerminalData, winner), t.winner);
+    put_field(dst, offsetof(TerminalData, pot), t.pot);
+    put_field(dst, offsetof(TerminalData, committed_total), t.committed_total);
+    put_field(dst, offsetof(TerminalData, chip_delta_if_forced), t.chip_delta_if_forced);
+}
+
+void put_record(unsigned char* dst, const TreeNode& n) {
+    static_assert(std::has_unique_object_representations_v<TreeNode>, "TreeNode has no padding");
+    std::memcpy(dst, &n, sizeof(n));
+}
+
+void put_record(unsigned char* dst, std::int32_t v) {
+    std::memcpy(dst, &v, sizeof(v));
+}
+
+// Writes one section and folds it into the checksum, in blocks through a zeroed buffer.
+template <typename T>
+void write_section(std::ofstream& out, const std::vector<T>& items, std::uint64_t& checksum) {
+    constexpr std::size_t kBlock = 4096;
+    std::vector<unsigned char> buf;
+    for (std::size_t first = 0; first < items.size(); first += kBlock) {
+        const std::size_t count = std::min(kBlock, items.size() - first);
+        const std::size_t bytes = count * sizeof(T);
+        buf.assign(first + count == items.size() ? padded(bytes) : bytes, 0);
+        for (std::size_t i = 0; i < count; ++i) {
+            put_record(buf.data() + i * sizeof(T), items[first + i]);
+        }
+        // Full blocks are a multiple of 8 bytes as kBlock is.
+        checksum = fnv1a64_words(buf.data(), buf.size(), checksum);
+        out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+    }
+}
+
+template <typename T>
+Span<T> take_section(const unsigned char*& p, std::uint64_t count, std::uint64_t bytes) {
+    const T* first = reinterpret_cast<const T*>(p);
+    p += bytes;
+    return {first, first + count};
+}
+
+// One pass over the nodes and edges checking every index the view hands out, so that a
+// corrupt file (or one opened without the checksum) fails here instead of on a later read.
+bool well_formed(const GameTreeView& tree) {
+    const std::size_t num_nodes = tree.nodes.size();
+    const std::size_t num_edges = tree.children.size();
+    for (const TreeNode& n : tree.nodes) {
+        if (n.street > Street::Terminal) {
+            return false;
+        }
+        switch (n.type) {
+            case NodeType::Terminal:
+                if (n.child_count != 0 || n.terminal < 0 ||
+                    static_cast<std::size_t>(n.terminal) >= tree.terminals.size()) {
+                    return false;
+                }
+                break;
+            case NodeType::Decision:
+                if (n.player > 1) {
+                    return false;
+                }
+                [[fallthrough]];
+            case NodeType::Chance:
+                if (static_cast<std::size_t>(n.first_child) + n.child_count > num_edges) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    for (std::size_t i = 0; i < num_edges; ++i) {
+        if (tree.children[i] < 0 || static_cast<std::size_t>(tree.children[i]) >= num_nodes ||
+            tree.actions[i].type > ActionType::Raise) {
+            return false;
+        }
+    }
+    for (const TerminalData& t : tree.terminals) {
+        if (t.kind > TerminalKind::Showdown || t.winner < -1 || t.winner > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void write_game_tree(const std::string& path, const GameTree& tree) {
+    TreeFileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kTreeFileVersion;
+    h.byte_order = kTreeFileByteOrder;
+    h.root_id = tree.root_id;
+    h.node_bytes = sizeof(TreeNode);
+    h.action_bytes = sizeof(TreeAction);
+    h.terminal_bytes = sizeof(TerminalData);
+    h.num_nodes = tree.nodes.size();
+    h.num_edges = tree.children.size();
+    h.num_terminals = tree.terminals.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    // The checksum follows the payload, so the header is rewritten once it is known.
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    std::uint64_t checksum = 0xcbf29ce484222325ULL;
+    write_section(out, tree.nodes, checksum);
+    write_section(out, tree.actions, checksum);
+    write_section(out, tree.children, checksum);
+    write_section(out, tree.terminals, checksum);
+    h.checksum = checksum;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    if (!out) {
+        throw std::runtime_error("failed to write tree file " + path);
+    }
+}
+
+const TreeFileHeader& MappedGameTree::header() const {
+    return *reinterpret_cast<const TreeFileHeader*>(file_.data());
+}
+
+MappedGameTree MappedGameTree::open(const std::string& path, bool verify_checksum) {
+    MappedGameTree t;
+    t.file_ = MappedFile::open(path);
+    if (t.file_.size() < sizeof(TreeFileHeader)) {
+        throw std::runtime_error(path + " is not a tree file");
+    }
+
+    const TreeFileHeader& h = t.header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error(path + " is not a tree file");
+    }
+    if (h.byte_order != kTreeFileByteOrder) {
+        throw std::runtime_error("tree file " + path + " was written with a different byte order");
+    }
+    if (h.version != kTreeFileVersion || h.node_bytes != sizeof(TreeNode) || h.action_bytes != sizeof(TreeAction) ||
+        h.terminal_bytes != sizeof(TerminalData)) {
+        throw std::runtime_error("tree file " + path + " has unsupported version or layout");
+    }
+
+    const std::uint64_t limit = t.file_.size();
+    if (h.num_nodes > limit || h.num_edges > limit || h.num_terminals > limit) {
+        throw std::runtime_error("tree file " + path + " has unexpected size");
+    }
+    const std::uint64_t nodes_bytes = padded(h.num_nodes * sizeof(TreeNode));
+    const std::uint64_t actions_bytes = padded(h.num_edges * sizeof(TreeAction));
+    const std::uint64_t children_bytes = padded(h.num_edges * sizeof(std::int32_t));
+    const std::uint64_t terminals_bytes = padded(h.num_terminals * sizeof(TerminalData));
+    if (t.file_.size() != sizeof(TreeFileHeader) + nodes_bytes + actions_bytes + children_bytes + terminals_bytes) {
+        throw std::runtime_error("tree file " + path + " has unexpected size");
+    }
+    if (h.num_nodes == 0 || h.root_id < 0 || static_cast<std::uint64_t>(h.root_id) >= h.num_nodes) {
+        throw std::runtime_error("tree file " + path + " has no valid root");
+    }
+
+    const unsigned char* payload = t.file_.data() + sizeof(TreeFileHeader);
+    if (verify_checksum && fnv1a64_words(payload, t.file_.size() - sizeof(TreeFileHeader)) != h.checksum) {
+        throw std::runtime_error("tree file " + path + " failed checksum");
+    }
+
+    const unsigned char* p = payload;
+    t.view_.root_id = h.root_id;
+    t.view_.nodes = take_section<TreeNode>(p, h.num_nodes, nodes_bytes);
+    t.view_.actions = take_section<TreeAction>(p, h.num_edges, actions_bytes);
+    t.view_.children = take_section<std::int32_t>(p, h.num_edges, children_bytes);
+    t.view_.terminals = take_section<TerminalData>(p, h.num_terminals, terminals_bytes);
+    if (!well_formed(t.view_)) {
+        throw std::runtime_error("tree file " + path + " has out-of-range nodes or edges");
+    }
+    return t;
+}
+
+} // namespace poker
@@ -0,0 +1,106 @@
+#include "tree_memo.hpp"
+
+#include "poker/rng.hpp"
+
+namespace poker::detail {
+
+NodeKey node_key(const TreeState& s, NodeType type) {
+    NodeKey k;
+    k.words = {static_cast<std::uint32_t>(s.committed_total[0]),
+               static_cast<std::uint32_t>(s.committed_total[1]),
+               static_cast<std::uint32_t>(s.committed_this_round[0]),
+               static_cast<std::uint32_t>(s.committed_this_round[1]),
+               static_cast<std::uint32_t>(s.current_bet),
+               static_cast<std::uint32_t>(s.last_bet_size),
+               static_cast<std::uint32_t>(s.raises_this_street),
+               static_cast<std::uint32_t>(s.street) | static_cast<std::uint32_t>(s.to_act) << 3 |
+                   static_cast<std::uint32_t>(s.folded[0]) << 4 | static_cast<std::uint32_t>(s.folded[1]) << 5 |
+                   static_cast<std::uint32_t>(s.acted_this_round[0]) << 6 |
+                   static_cast<std::uint32_t>(s.acted_this_round[1]) << 7 | static_cast<std::uint32_t>(type) << 8};
+    return k;
+}
+
+std::uint64_t node_hash(const TreeState& s, NodeType type) {
+    return s.hash + split_mix64(static_cast<std::uint64_t>(type));
+}
+
+NodeMemo::NodeMemo(std::size_t expected_nodes) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * expected_nodes) {
+        capacity *= 2;
+    }
+    rehash(capacity);
+    keys_.reserve(expected_nodes);
+}
+
+int NodeMemo::find(const NodeKey& key, std::uint64_t hash) const {
+    const std::uint32_t tag = tag_of(hash);
+    for (std::size_t i = home(tag);; i = (i + 1) & mask_) {
+        const Slot& slot = slots_[i];
+        if (slot.id < 0) {
+            return -1;
+        }
+        if (slot.tag == tag && keys_[static_cast<std::size_t>(slot.id)] == key) {
+            return slot.id;
+        }
+    }
+}
+
+void NodeMemo::insert(const NodeKey& key, std::uint64_t hash, int id) {
+    if (2 * (size_ + 1) > slots_.size()) {
+        rehash(2 * slots_.size());
+    }
+    const std::uint32_t tag = tag_of(hash);
+    std::size_t i = home(tag);
+    while (slots_[i].id >= 0) {
+        i = (i + 1) & mask_;
+    }
+    slots_[i] = Slot{tag, id};
+    if (static_cast<std::size_t>(id) >= keys_.size()) {
+        keys_.resize(static_cast<std::size_t>(id) + 1);
+    }
+    keys_[static_cast<std::size_t>(id)] = key;
+    ++size_;
+}
+
+void NodeMemo::rehash(std::size_t capacity) {
+    std::vector<Slot> old(capacity);
+    old.swap(slots_);
+    mask_ = capacity - 1;
+    shift_ = 32;
+    for (std::size_t c = capacity; c > 1; c /= 2) {
+        --shift_;
+    }
+    for (const Slot& slot : old) {
+        if (slot.id >= 0) {
+            std::size_t i = home(slot.tag);
+            while (slots_[i].id >= 0) {
+                i = (i + 1) & mask_;
+            }
+            slots_[i] = slot;
+        }
+    }
+}
+
+SharedNodeMemo::SharedNodeMemo(std::size_t expected_nodes) : shards_(kShards) {
+    for (Shard& shard : shards_) {
+        shard.memo = NodeMemo(expected_nodes / kShards);
+    }
+}
+
+std::uint64_t SharedNodeMemo::find_or_insert(const NodeKey& key, std::uint64_t hash, std::uint64_t value,
+                                             bool& inserted) {
+    // The shard memos index by the high bits of the hash, so shards pick by a remix of it.
+    Shard& shard = shards_[split_mix64(hash) & (kShards - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const int found = shard.memo.find(key, hash);
+    inserted = found < 0;
+    if (!inserted) {
+        return shard.values[static_cast<std::size_t>(found)];
+    }
+    shard.memo.insert(key, hash, static_cast<int>(shard.values.size()));
+    shard.values.push_back(value);
+    return value;
+}
+
+} // namespace poker::detail
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "poker/tree.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace poker::detail {
+
+// Fixed-width binary identity of a tree node: its type plus the TreeState betting fields.
+// Stacks, pot and bet_to_call are left out; within one build they follow from the
+// commitments. The terminal kind follows from the fold flags.
+struct NodeKey {
+    std::array<std::uint32_t, 8> words{};
+
+    bool operator==(const NodeKey& o) const { return words == o.words; }
+};
+
+NodeKey node_key(const TreeState& s, NodeType type);
+// The state's Zobrist hash with the node type mixed in.
+std::uint64_t node_hash(const TreeState& s, NodeType type);
+
+// Open-addressing map from NodeKey to node id with linear probing. Keys are stored once,
+// densely by id; a slot holds only the id and the top 32 bits of the hash, which both
+// pick the home slot and filter key comparisons. The slot count is a power of two, grown
+// to keep the table at most half full, so a node costs its key plus 16 to 32 bytes.
+class NodeMemo {
+public:
+    explicit NodeMemo(std::size_t expected_nodes);
+
+    // The id stored for `key`, or -1.
+    int find(const NodeKey& key, std::uint64_t hash) const;
+    // `key` must not be present; ids should be dense from 0.
+    void insert(const NodeKey& key, std::uint64_t hash, int id);
+
+    std::size_t size() const { return size_; }
+
+private:
+    struct Slot {
+        std::uint32_t tag = 0;
+        int id = -1; // -1: empty
+    };
+
+    static std::uint32_t tag_of(std::uint64_t hash) { return static_cast<std::uint32_t>(hash >> 32); }
+    std::size_t home(std::uint32_t tag) const { return static_cast<std::size_t>(tag >> shift_); }
+    void rehash(std::size_t capacity);
+
+    std::vector<Slot> slots_;
+    std::vector<NodeKey> keys_;
+    std::size_t mask_ = 0;
+    int shift_ = 32;
+    std::size_t size_ = 0;
+};
+
+// NodeMemo for concurrent builders: keys map to caller-chosen 64-bit values and are spread
+// over independently locked shards.
+class SharedNodeMemo {
+public:
+    explicit SharedNodeMemo(std::size_t expected_nodes);
+
+    // The value stored for `key`; if absent, stores `value` and sets `inserted`.
+    std::uint64_t find_or_insert(const NodeKey& key, std::uint64_t hash, std::uint64_t value, bool& inserted);
+
+private:
+    static constexpr std::size_t kShards = 256;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        NodeMemo memo{0};
+        std::vector<std::uint64_t> values; // by shard-local id
+    };
+
+    std::vector<Shard> shards_;
+};
+
+} // namespace poker::detail
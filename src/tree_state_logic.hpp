@@ -18,6 +18,10 @@ int street_index(Street s);
 std::string state_key(const TreeState& s);
 TreeState initial_state(const BettingAbstraction& ab);
 std::vector<Action> legal_actions(const TreeState& s, const BettingAbstraction& ab);
+void legal_actions(const TreeState& s, const BettingAbstraction& ab, ActionBuffer& out);
+// The edges of a decision node: from `generate` when set, else from the abstraction's sizes.
+void node_actions(const TreeState& s, const BettingAbstraction& ab, TreeBuilder::ActionGenerator generate,
+                  ActionBuffer& out);
 Transition apply_action(const TreeState& input, const Action& a);
 TerminalData terminal_from_state(const TreeState& s, TerminalKind kind);
 
@@ -0,0 +1,157 @@
+// Checks BoardRanking's linear-time showdown values against a pairwise O(n^2) reference on
+// random boards, reaches and payoffs, and the canonical ranking cache against the
+// evaluator.
+
+#include "poker/board_ranking.hpp"
+#include "poker/card_set.hpp"
+#include "poker/cards.hpp"
+#include "poker/hand_eval.hpp"
+#include "poker/isomorphism.hpp"
+#include "poker/rng.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+std::array<int, 5> random_board(poker::Xoshiro256StarStar& rng) {
+    std::array<int, 5> board{};
+    poker::CardSet used;
+    for (int& c : board) {
+        do {
+            c = static_cast<int>(poker::uniform_below(rng, poker::kNumCards));
+        } while (used.contains(c));
+        used.insert(c);
+    }
+    return board;
+}
+
+poker::CardSet board_set(const std::array<int, 5>& board) {
+    poker::CardSet s;
+    for (int c : board) {
+        s.insert(c);
+    }
+    return s;
+}
+
+double uniform01(poker::Xoshiro256StarStar& rng) {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+// out[c] = sum over card-compatible opponent combos o of reach[o] times c's payoff against o.
+std::vector<double> reference_values(const std::array<int, 5>& board, const std::vector<double>& reach,
+                                     const poker::ShowdownPayoffs& payoffs) {
+    const poker::CardSet board_cards = board_set(board);
+    std::vector<int> scores(poker::kNumCombos, -1);
+    for (int c = 0; c < poker::kNumCombos; ++c) {
+        const auto& cards = poker::combo_cards(c);
+        if (!poker::CardSet::of(cards).intersects(board_cards)) {
+            scores[static_cast<std::size_t>(c)] = poker::evaluate_hand(cards, board);
+        }
+    }
+    std::vector<double> out(poker::kNumCombos, 0.0);
+    for (int c = 0; c < poker::kNumCombos; ++c) {
+        const int sc = scores[static_cast<std::size_t>(c)];
+        if (sc < 0) {
+            continue;
+        }
+        const poker::CardSet mine = poker::CardSet::of(poker::combo_cards(c));
+        double v = 0.0;
+        for (int o = 0; o < poker::kNumCombos; ++o) {
+            const int so = scores[static_cast<std::size_t>(o)];
+            if (so < 0 || mine.intersects(poker::CardSet::of(poker::combo_cards(o)))) {
+                continue;
+            }
+            v += reach[static_cast<std::size_t>(o)] * (sc > so ? payoffs.win : (sc < so ? payoffs.lose : payoffs.tie));
+        }
+        out[static_cast<std::size_t>(c)] = v;
+    }
+    return out;
+}
+
+// Every holding scored as evaluate_hand scores it, sorted weakest first in tie groups.
+bool check_layout(const poker::BoardRanking& r) {
+    const auto& hands = r.hands();
+    const auto& offsets = r.group_offsets();
+    bool ok = hands.size() == 1081 && offsets.front() == 0 &&
+              offsets.back() == static_cast<int>(hands.size());
+    for (std::size_t i = 0; ok && i < hands.size(); ++i) {
+        ok = hands[i].score == poker::evaluate_hand(poker::combo_cards(hands[i].combo), r.board()) &&
+             r.score(hands[i].combo) == hands[i].score && (i == 0 || hands[i - 1].score <= hands[i].score);
+    }
+    for (int g = 0; ok && g < r.num_groups(); ++g) {
+        const auto first = static_cast<std::size_t>(offsets[static_cast<std::size_t>(g)]);
+        const auto last = static_cast<std::size_t>(offsets[static_cast<std::size_t>(g) + 1]);
+        ok = first < last && hands[first].score == hands[last - 1].score &&
+             (first == 0 || hands[first - 1].score < hands[first].score);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    constexpr int kBoards = 200;
+    constexpr double kTolerance = 1e-9;
+    poker::Xoshiro256StarStar rng(2024);
+
+    int layout_failures = 0;
+    double max_error = 0.0;
+    for (int b = 0; b < kBoards; ++b) {
+        const std::array<int, 5> board = random_board(rng);
+        const poker::BoardRanking ranking(board);
+        layout_failures += !check_layout(ranking);
+
+        // Sparse reaches too, as the CFR ranges that feed this often zero out most combos.
+        const double density = (b % 4 == 0) ? 0.1 : 1.0;
+        std::vector<double> reach(poker::kNumCombos, 0.0);
+        for (double& x : reach) {
+            x = uniform01(rng) < density ? uniform01(rng) : 0.0;
+        }
+        const poker::ShowdownPayoffs payoffs{1.0 + 99.0 * uniform01(rng), -1.0 - 99.0 * uniform01(rng),
+                                             uniform01(rng) - 0.5};
+
+        std::vector<double> out;
+        ranking.showdown_values(reach, payoffs, out);
+        const std::vector<double> expected = reference_values(board, reach, payoffs);
+        for (int c = 0; c < poker::kNumCombos; ++c) {
+            const double e = expected[static_cast<std::size_t>(c)];
+            const double err = std::abs(out[static_cast<std::size_t>(c)] - e) / std::max(1.0, std::abs(e));
+            max_error = std::max(max_error, err);
+        }
+    }
+    const bool values_ok = max_error <= kTolerance;
+    std::cout << "ranking layout: " << (layout_failures == 0 ? "ok" : "FAILED") << " (" << kBoards << " boards, "
+              << layout_failures << " mismatches)\n";
+    std::cout << "showdown values vs pairwise reference: " << (values_ok ? "ok" : "FAILED")
+              << " (max relative error " << max_error << ")\n";
+
+    // A canonical ranking scores every combo mapped into its suits as the original board
+    // scores the combo itself.
+    poker::BoardRankingCache cache;
+    int canonical_failures = 0;
+    for (int b = 0; b < kBoards; ++b) {
+        const std::array<int, 5> board = random_board(rng);
+        const poker::CanonicalRanking canonical = cache.get_canonical(board);
+        const poker::CardSet board_cards = board_set(board);
+        for (int c = 0; c < poker::kNumCombos; ++c) {
+            const auto& cards = poker::combo_cards(c);
+            if (poker::CardSet::of(cards).intersects(board_cards)) {
+                continue;
+            }
+            const auto mapped = poker::apply_suit_permutation(cards, canonical.perm);
+            if (canonical.ranking->score(poker::combo_index(mapped[0], mapped[1])) !=
+                poker::evaluate_hand(cards, board)) {
+                ++canonical_failures;
+            }
+        }
+    }
+    std::cout << "canonical rankings: " << (canonical_failures == 0 ? "ok" : "FAILED") << " (" << cache.size()
+              << " rankings, " << canonical_failures << " mismatches)\n";
+
+    return layout_failures == 0 && values_ok && canonical_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+// Checks the table-driven evaluator against the original best-of-21 evaluator it replaced,
+// kept here verbatim as the reference.
+
+#include "poker/card_set.hpp"
+#include "poker/hand_eval.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+int rank_of(int card) {
+    return (card % 13) + 2; // 2..14
+}
+
+int suit_of(int card) {
+    return card / 13; // 0..3
+}
+
+int pack_score(int category, const std::vector<int>& kickers_desc) {
+    int score = category;
+    for (int i = 0; i < 5; ++i) {
+        const int k = i < static_cast<int>(kickers_desc.size()) ? kickers_desc[static_cast<std::size_t>(i)] : 0;
+        score = score * 15 + k;
+    }
+    return score;
+}
+
+int evaluate_5cards(const std::array<int, 5>& cards) {
+    std::array<int, 15> rank_count{};
+    std::array<int, 4> suit_count{};
+    std::vector<int> ranks;
+    ranks.reserve(5);
+
+    for (int c : cards) {
+        const int r = rank_of(c);
+        const int s = suit_of(c);
+        rank_count[r]++;
+        suit_count[s]++;
+        ranks.push_back(r);
+    }
+
+    std::sort(ranks.begin(), ranks.end(), std::greater<int>());
+
+    const bool is_flush = std::any_of(suit_count.begin(), suit_count.end(), [](int c) { return c == 5; });
+
+    std::vector<int> unique_ranks = ranks;
+    unique_ranks.erase(std::unique(unique_ranks.begin(), unique_ranks.end()), unique_ranks.end());
+    std::sort(unique_ranks.begin(), unique_ranks.end());
+
+    bool is_straight = false;
+    int straight_high = 0;
+    if (unique_ranks.size() == 5) {
+        if (unique_ranks.back() - unique_ranks.front() == 4) {
+            is_straight = true;
+            straight_high = unique_ranks.back();
+        } else if (unique_ranks == std::vector<int>{2, 3, 4, 5, 14}) {
+            is_straight = true;
+            straight_high = 5;
+        }
+    }
+
+    if (is_straight && is_flush) {
+        return pack_score(8, {straight_high});
+    }
+
+    std::vector<int> fours;
+    std::vector<int> threes;
+    std::vector<int> pairs;
+    std::vector<int> singles;
+
+    for (int r = 14; r >= 2; --r) {
+        if (rank_count[r] == 4) {
+            fours.push_back(r);
+        } else if (rank_count[r] == 3) {
+            threes.push_back(r);
+        } else if (rank_count[r] == 2) {
+            pairs.push_back(r);
+        } else if (rank_count[r] == 1) {
+            singles.push_back(r);
+        }
+    }
+
+    if (!fours.empty()) {
+        return pack_score(7, {fours[0], singles[0]});
+    }
+    if (!threes.empty() && !pairs.empty()) {
+        return pack_score(6, {threes[0], pairs[0]});
+    }
+    if (is_flush) {
+        return pack_score(5, ranks);
+    }
+    if (is_straight) {
+        return pack_score(4, {straight_high});
+    }
+    if (!threes.empty()) {
+        return pack_score(3, {threes[0], singles[0], singles[1]});
+    }
+    if (pairs.size() >= 2) {
+        return pack_score(2, {pairs[0], pairs[1], singles[0]});
+    }
+    if (pairs.size() == 1) {
+        return pack_score(1, {pairs[0], singles[0], singles[1], singles[2]});
+    }
+    return pack_score(0, ranks);
+}
+
+int reference_7cards(const std::array<int, 7>& all) {
+    int best = -1;
+    for (int a = 0; a < 7; ++a) {
+        for (int b = a + 1; b < 7; ++b) {
+            std::array<int, 5> five{};
+            int idx = 0;
+            for (int i = 0; i < 7; ++i) {
+                if (i == a || i == b) continue;
+                five[idx++] = all[static_cast<std::size_t>(i)];
+            }
+            best = std::max(best, evaluate_5cards(five));
+        }
+    }
+    return best;
+}
+
+std::uint64_t mask_of(const int* cards, int n) {
+    std::uint64_t m = 0;
+    for (int i = 0; i < n; ++i) {
+        m |= std::uint64_t{1} << cards[i];
+    }
+    return m;
+}
+
+// Binomial coefficients for colexicographic ranks of 5-card subsets.
+struct Binomials {
+    std::array<std::array<int, 6>, 53> c{};
+
+    Binomials() {
+        for (int n = 0; n <= 52; ++n) {
+            c[static_cast<std::size_t>(n)][0] = 1;
+            for (int k = 1; k <= 5; ++k) {
+                c[static_cast<std::size_t>(n)][static_cast<std::size_t>(k)] =
+                    n == 0 ? 0 : c[static_cast<std::size_t>(n - 1)][static_cast<std::size_t>(k - 1)] +
+                                     c[static_cast<std::size_t>(n - 1)][static_cast<std::size_t>(k)];
+            }
+        }
+    }
+
+    // Rank of the ascending cards h[0] < ... < h[4].
+    int rank5(const int* h) const {
+        int r = 0;
+        for (int i = 0; i < 5; ++i) {
+            r += c[static_cast<std::size_t>(h[i])][static_cast<std::size_t>(i + 1)];
+        }
+        return r;
+    }
+};
+
+// Every 5-card hand against the reference; fills `table` with the reference scores by
+// colexicographic rank.
+std::uint64_t check_all_5card(const Binomials& bin, std::vector<int>& table) {
+    std::uint64_t bad = 0;
+    table.assign(2598960, -1);
+    std::array<int, 5> h{};
+    for (h[4] = 4; h[4] < 52; ++h[4])
+    for (h[3] = 3; h[3] < h[4]; ++h[3])
+    for (h[2] = 2; h[2] < h[3]; ++h[2])
+    for (h[1] = 1; h[1] < h[2]; ++h[1])
+    for (h[0] = 0; h[0] < h[1]; ++h[0]) {
+        const int expected = evaluate_5cards(h);
+        table[static_cast<std::size_t>(bin.rank5(h.data()))] = expected;
+        bad += poker::evaluate_card_mask(mask_of(h.data(), 5)) != expected;
+    }
+    return bad;
+}
+
+// Every 7-card hand against the best of its 21 subsets, read from the 5-card table.
+std::uint64_t check_all_7card(const Binomials& bin, const std::vector<int>& table, std::uint64_t& hands) {
+    std::uint64_t bad = 0;
+    std::array<int, 7> h{};
+    for (h[6] = 6; h[6] < 52; ++h[6])
+    for (h[5] = 5; h[5] < h[6]; ++h[5])
+    for (h[4] = 4; h[4] < h[5]; ++h[4])
+    for (h[3] = 3; h[3] < h[4]; ++h[3])
+    for (h[2] = 2; h[2] < h[3]; ++h[2])
+    for (h[1] = 1; h[1] < h[2]; ++h[1])
+    for (h[0] = 0; h[0] < h[1]; ++h[0]) {
+        int best = -1;
+        for (int a = 0; a < 7; ++a) {
+            for (int b = a + 1; b < 7; ++b) {
+                std::array<int, 5> five{};
+                int idx = 0;
+                for (int i = 0; i < 7; ++i) {
+                    if (i != a && i != b) {
+                        five[static_cast<std::size_t>(idx++)] = h[static_cast<std::size_t>(i)];
+                    }
+                }
+                best = std::max(best, table[static_cast<std::size_t>(bin.rank5(five.data()))]);
+            }
+        }
+        ++hands;
+        bad += poker::evaluate_7cards(h) != best;
+    }
+    return bad;
+}
+
+// A fixed stride of 7-card hands straight against the reference loop, which ties the
+// table-based check above to the original code path.
+std::uint64_t check_sampled_7card() {
+    std::uint64_t bad = 0;
+    std::uint64_t n = 0;
+    std::array<int, 7> h{};
+    for (h[6] = 6; h[6] < 52; ++h[6])
+    for (h[5] = 5; h[5] < h[6]; ++h[5])
+    for (h[4] = 4; h[4] < h[5]; ++h[4])
+    for (h[3] = 3; h[3] < h[4]; ++h[3])
+    for (h[2] = 2; h[2] < h[3]; ++h[2])
+    for (h[1] = 1; h[1] < h[2]; ++h[1])
+    for (h[0] = 0; h[0] < h[1]; ++h[0]) {
+        if (n++ % 9973 == 0) {
+            bad += poker::evaluate_7cards(h) != reference_7cards(h);
+        }
+    }
+    return bad;
+}
+
+// The batch kernel (AVX2 where available) and HandAccumulator against evaluate_hand on a
+// fixed stride of boards, every hole pair included; pairs touching the board score -1.
+std::uint64_t check_batch() {
+    std::uint64_t bad = 0;
+    std::vector<std::array<int, 2>> holes;
+    for (int a = 0; a < 52; ++a) {
+        for (int b = a + 1; b < 52; ++b) {
+            holes.push_back({a, b});
+        }
+    }
+    holes.push_back({7, 7});
+
+    std::vector<int> scores;
+    std::uint64_t n = 0;
+    std::array<int, 5> board{};
+    for (board[4] = 4; board[4] < 52; ++board[4])
+    for (board[3] = 3; board[3] < board[4]; ++board[3])
+    for (board[2] = 2; board[2] < board[3]; ++board[2])
+    for (board[1] = 1; board[1] < board[2]; ++board[1])
+    for (board[0] = 0; board[0] < board[1]; ++board[0]) {
+        if (n++ % 4999 != 0) {
+            continue;
+        }
+        poker::evaluate_board_batch(board, holes, scores);
+        const std::uint64_t board_mask = mask_of(board.data(), 5);
+        for (std::size_t i = 0; i < holes.size(); ++i) {
+            const std::uint64_t hole_mask = mask_of(holes[i].data(), 2);
+            const bool clash = (hole_mask & board_mask) != 0 || holes[i][0] == holes[i][1];
+            const int expected = clash ? -1 : poker::evaluate_hand(holes[i], board);
+            bad += scores[i] != expected;
+            if (!clash) {
+                poker::HandAccumulator acc(holes[i], std::vector<int>(board.begin(), board.begin() + 4));
+                bad += acc.score_with(board[4]) != expected;
+            }
+        }
+    }
+    return bad;
+}
+
+bool report(const char* name, std::uint64_t bad) {
+    std::cout << name << ": " << (bad == 0 ? "ok" : "FAILED") << " (" << bad << " mismatches)\n";
+    return bad == 0;
+}
+
+} // namespace
+
+int main() {
+    const Binomials bin;
+    std::vector<int> table;
+    bool ok = report("all 5-card hands", check_all_5card(bin, table));
+    std::uint64_t hands = 0;
+    ok &= report("all 7-card hands", check_all_7card(bin, table, hands));
+    ok &= hands == 133784560;
+    ok &= report("sampled 7-card hands vs best-of-21", check_sampled_7card());
+    ok &= report("board batch and HandAccumulator", check_batch());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Checks suit-isomorphism canonicalization: the number of board classes and their weights,
+// the weights of canonical next cards, and that relabelled suits canonicalize alike.
+
+#include "poker/cards.hpp"
+#include "poker/isomorphism.hpp"
+#include "poker/rng.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+bool report(const char* name, bool ok) {
+    std::cout << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+std::vector<int> random_cards(poker::Xoshiro256StarStar& rng, int n) {
+    std::array<int, poker::kNumCards> deck{};
+    std::iota(deck.begin(), deck.end(), 0);
+    for (int i = 0; i < n; ++i) {
+        const auto j = static_cast<std::size_t>(i) + poker::uniform_below(rng, static_cast<std::uint32_t>(poker::kNumCards - i));
+        std::swap(deck[static_cast<std::size_t>(i)], deck[j]);
+    }
+    return {deck.begin(), deck.begin() + n};
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+
+    // Classes of unordered 3, 4 and 5 card boards; their weights count every board once.
+    const std::array<std::size_t, 3> classes{1755, 16432, 134459};
+    const std::array<std::int64_t, 3> boards{22100, 270725, 2598960};
+    for (int n = 3; n <= 5; ++n) {
+        const std::vector<poker::WeightedBoard> canonical = poker::canonical_boards(n);
+        std::int64_t weight = 0;
+        for (const auto& b : canonical) {
+            weight += b.weight;
+        }
+        const auto i = static_cast<std::size_t>(n - 3);
+        std::cout << n << "-card boards: " << canonical.size() << " classes, weight " << weight << "\n";
+        ok &= report(n == 3 ? "flop classes" : (n == 4 ? "turn classes" : "river classes"),
+                     canonical.size() == classes[i] && weight == boards[i]);
+    }
+
+    // Next cards of a chance node stand for every card not on the board, once.
+    poker::Xoshiro256StarStar rng(99);
+    bool next_ok = true;
+    for (int trial = 0; trial < 1000; ++trial) {
+        const std::vector<int> board = random_cards(rng, 3 + trial % 2);
+        int weight = 0;
+        for (const auto& c : poker::canonical_next_cards(board)) {
+            weight += c.weight;
+            next_ok &= std::find(board.begin(), board.end(), c.card) == board.end();
+        }
+        next_ok &= weight == poker::kNumCards - static_cast<int>(board.size());
+    }
+    ok &= report("next card weights", next_ok);
+
+    // Relabelling the suits of a board and holdings leaves the canonical form unchanged.
+    bool relabel_ok = true;
+    std::array<int, 4> suits{0, 1, 2, 3};
+    for (int trial = 0; trial < 10000; ++trial) {
+        const std::vector<int> cards = random_cards(rng, 3 + trial % 3 + 4);
+        const std::vector<int> board(cards.begin() + 4, cards.end());
+        const std::vector<std::array<int, 2>> holdings{{cards[0], cards[1]}, {cards[2], cards[3]}};
+        std::next_permutation(suits.begin(), suits.end());
+        const auto relabel = [&](int c) {
+            return poker::make_card(poker::card_rank_index(c), suits[static_cast<std::size_t>(poker::card_suit(c))]);
+        };
+        std::vector<int> board2;
+        for (int c : board) {
+            board2.push_back(relabel(c));
+        }
+        const std::vector<std::array<int, 2>> holdings2{{relabel(cards[0]), relabel(cards[1])},
+                                                         {relabel(cards[2]), relabel(cards[3])}};
+        const poker::CanonicalSpot a = poker::canonicalize(board, holdings);
+        const poker::CanonicalSpot b = poker::canonicalize(board2, holdings2);
+        relabel_ok &= a.board.key == b.board.key && a.board.cards == b.board.cards && a.holdings == b.holdings &&
+                      poker::canonicalize_board(board).key == poker::canonicalize_board(board2).key;
+    }
+    ok &= report("suit relabelling", relabel_ok);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+// Round-trips a preflop equity table file and checks that a file from another byte order or
+// with a corrupted payload is rejected.
+
+#include "poker/preflop_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool opens(const std::string& path) {
+    try {
+        poker::PreflopEquityTable::open(path);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool rejects(const std::string& path, const std::string& corrupt_path, std::size_t offset, const void* bytes,
+             std::size_t size) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> file{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    std::memcpy(file.data() + offset, bytes, size);
+    std::ofstream(corrupt_path, std::ios::binary | std::ios::trunc)
+        .write(file.data(), static_cast<std::streamsize>(file.size()));
+    return !opens(corrupt_path);
+}
+
+bool report(const char* name, bool ok) {
+    std::cout << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    const std::string path = "preflop_table_test.bin";
+    const std::string corrupt_path = "preflop_table_test_corrupt.bin";
+    constexpr std::size_t kEntries = static_cast<std::size_t>(poker::kNumPreflopClasses) * poker::kNumPreflopClasses;
+    std::vector<float> equities(kEntries);
+    for (std::size_t i = 0; i < kEntries; ++i) {
+        equities[i] = static_cast<float>(i) / static_cast<float>(kEntries);
+    }
+    poker::write_preflop_table(path, equities, 4096);
+
+    bool ok = true;
+    {
+        const poker::PreflopEquityTable table = poker::PreflopEquityTable::open(path);
+        bool same = !table.exact() && table.header().samples_per_matchup == 4096 &&
+                    table.header().byte_order == poker::kPreflopTableByteOrder;
+        for (int h = 0; same && h < poker::kNumPreflopClasses; ++h) {
+            for (int v = 0; same && v < poker::kNumPreflopClasses; ++v) {
+                same = table.equity(h, v) == equities[static_cast<std::size_t>(h * poker::kNumPreflopClasses + v)];
+            }
+        }
+        ok &= report("round trip", same);
+    }
+
+    const std::uint32_t swapped = 0x04030201;
+    ok &= report("byte order", rejects(path, corrupt_path, offsetof(poker::PreflopTableHeader, byte_order), &swapped,
+                                       sizeof(swapped)));
+    const float wrong = 2.0f;
+    ok &= report("payload checksum", rejects(path, corrupt_path, sizeof(poker::PreflopTableHeader), &wrong,
+                                             sizeof(wrong)));
+
+    std::remove(path.c_str());
+    std::remove(corrupt_path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// Checks that Rules::undo_action restores a State exactly: every node of shallow action
+// trees below random deals is applied and undone, and the state after the undo must match
+// the state before, deck order and hash included. Also checks that the incremental hash
+// always equals the hash computed from scratch.
+
+#include "poker/rng.hpp"
+#include "poker/rules.hpp"
+#include "poker/zobrist.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <tuple>
+
+namespace {
+
+auto fields(const poker::State& s) {
+    return std::tie(s.street, s.pot, s.stacks, s.to_act, s.bet_to_call, s.last_bet_size, s.current_bet,
+                    s.committed_this_round, s.committed_total, s.folded, s.acted_this_round,
+                    s.raises_this_street, s.hole_cards, s.hash);
+}
+
+auto fields(const poker::Action& a) {
+    return std::tie(a.player, a.type, a.amount, a.to_call_before, a.street);
+}
+
+bool same_state(const poker::State& a, const poker::State& b) {
+    if (fields(a) != fields(b) || a.history.size() != b.history.size() || a.board.size() != b.board.size() ||
+        !(a.used_cards == b.used_cards) || std::memcmp(&a.deck, &b.deck, sizeof(poker::Deck)) != 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.history.size(); ++i) {
+        if (fields(a.history[i]) != fields(b.history[i])) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < a.board.size(); ++i) {
+        if (a.board[i] != b.board[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class UndoChecker {
+public:
+    explicit UndoChecker(const poker::Rules& rules) : rules_(rules) {}
+
+    // Applies every legal action of `s` down to `depth` plies, undoing each on the way back.
+    void walk(poker::State& s, int depth, poker::Xoshiro256StarStar& rng) {
+        if (depth == 0 || s.street == poker::Street::Terminal) {
+            return;
+        }
+        poker::ActionBuffer legal;
+        rules_.legal_actions(s, legal);
+        for (const poker::Action& a : legal) {
+            const poker::State before = s;
+            poker::UndoRecord undo;
+            rules_.apply_action_unchecked(s, a, rng, undo);
+            ++pairs_;
+            hash_mismatches_ += s.hash != poker::zobrist::hash(s);
+            walk(s, depth - 1, rng);
+            rules_.undo_action(s, undo);
+            if (!same_state(s, before)) {
+                ++mismatches_;
+                s = before;
+            }
+        }
+    }
+
+    std::uint64_t pairs() const { return pairs_; }
+    std::uint64_t mismatches() const { return mismatches_; }
+    std::uint64_t hash_mismatches() const { return hash_mismatches_; }
+
+private:
+    const poker::Rules& rules_;
+    std::uint64_t pairs_ = 0;
+    std::uint64_t mismatches_ = 0;
+    std::uint64_t hash_mismatches_ = 0;
+};
+
+bool check_undo(const char* name, const poker::RulesConfig& config, int deals, int depth) {
+    const poker::Rules rules(config);
+    poker::Xoshiro256StarStar rng(7);
+    UndoChecker checker(rules);
+    for (int d = 0; d < deals; ++d) {
+        poker::State s = rules.new_hand(rng);
+        checker.walk(s, depth, rng);
+    }
+    const bool ok = checker.mismatches() == 0 && checker.hash_mismatches() == 0;
+    std::cout << name << " apply/undo: " << (ok ? "ok" : "FAILED") << " (" << checker.pairs() << " pairs, "
+              << checker.mismatches() << " state and " << checker.hash_mismatches() << " hash mismatches)\n";
+    return ok && checker.pairs() > 0;
+}
+
+// Random hands to the end, comparing the incremental hash with a from-scratch one after
+// every action.
+bool check_hash(const char* name, const poker::RulesConfig& config, int hands) {
+    const poker::Rules rules(config);
+    poker::Xoshiro256StarStar rng(11);
+    std::uint64_t actions = 0;
+    std::uint64_t mismatches = 0;
+    for (int h = 0; h < hands; ++h) {
+        poker::State s = rules.new_hand(rng);
+        mismatches += s.hash != poker::zobrist::hash(s);
+        while (s.street != poker::Street::Terminal) {
+            rules.apply_action_unchecked(s, rules.random_legal_action(s, rng), rng);
+            mismatches += s.hash != poker::zobrist::hash(s);
+            ++actions;
+        }
+    }
+    std::cout << name << " incremental hash: " << (mismatches == 0 ? "ok" : "FAILED") << " (" << actions
+              << " actions, " << mismatches << " mismatches)\n";
+    return mismatches == 0;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= check_undo("default rules", poker::RulesConfig{}, 200, 5);
+
+    // Short stacks reach all-ins, and with them the run-out deals, within a few plies.
+    poker::RulesConfig short_stacks;
+    short_stacks.starting_stack = 60;
+    ok &= check_undo("short stacks", short_stacks, 200, 6);
+
+    ok &= check_hash("default rules", poker::RulesConfig{}, 200000);
+    ok &= check_hash("short stacks", short_stacks, 100000);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// Shadows every StateBatch lane with a State driven by Rules and checks, after every
+// action, that both agree on the legal actions, the betting fields, the revealed board and
+// the terminal payoff.
+
+#include "poker/rng.hpp"
+#include "poker/rules.hpp"
+#include "poker/state_batch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+auto betting_fields(const poker::State& s) {
+    return std::tie(s.street, s.pot, s.stacks, s.to_act, s.bet_to_call, s.last_bet_size, s.current_bet,
+                    s.committed_this_round, s.committed_total, s.folded, s.acted_this_round,
+                    s.raises_this_street);
+}
+
+std::vector<std::tuple<poker::ActionType, int>> sorted_actions(const std::vector<poker::Action>& actions) {
+    std::vector<std::tuple<poker::ActionType, int>> out;
+    for (const poker::Action& a : actions) {
+        out.emplace_back(a.type, a.amount);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// The batch deals all cards at reset; the shadow takes its cards from the lane so that
+// both hands see the same showdown.
+void copy_cards(const poker::State& lane, poker::State& shadow) {
+    shadow.hole_cards = lane.hole_cards;
+    shadow.board = lane.board;
+    shadow.used_cards = lane.used_cards;
+}
+
+struct Shadow {
+    poker::State state;
+    std::uint64_t hand = 0;
+};
+
+class Checker {
+public:
+    Checker(const std::string& name, const poker::RulesConfig& config) : name_(name), rules_(config) {}
+
+    // Plays `hands` hands through `lanes` lanes, refilling lanes as their hands finish.
+    bool run(std::size_t lanes, std::uint64_t hands) {
+        poker::StateBatch batch(lanes, rules_.config());
+        std::vector<Shadow> shadows(batch.size());
+        std::vector<std::int32_t> delta(batch.size());
+        poker::Xoshiro256StarStar rng(0x5eedULL);
+
+        std::uint64_t next = 0;
+        std::size_t live = 0;
+        for (std::size_t lane = 0; lane < batch.size(); ++lane) {
+            live += start(batch, shadows, lane, next, hands, rng);
+        }
+        while (live > 0) {
+            batch.compute_legal();
+            for (std::size_t lane = 0; lane < batch.size(); ++lane) {
+                if (!batch.terminal(lane)) {
+                    choose(batch, shadows[lane], lane, rng);
+                }
+            }
+            std::vector<bool> was_live(batch.size());
+            for (std::size_t lane = 0; lane < batch.size(); ++lane) {
+                was_live[lane] = !batch.terminal(lane);
+            }
+            batch.apply();
+            batch.payoffs(delta.data());
+            for (std::size_t lane = 0; lane < batch.size(); ++lane) {
+                if (!was_live[lane]) {
+                    continue;
+                }
+                Shadow& shadow = shadows[lane];
+                const poker::State lane_state = batch.state(lane);
+                if (shadow.state.board.size() != lane_state.board.size()) {
+                    fail(shadow, "revealed board differs");
+                }
+                shadow.state.board = lane_state.board;
+                shadow.state.used_cards = lane_state.used_cards;
+                compare_state(batch, shadow, lane, lane_state);
+                if (batch.terminal(lane)) {
+                    compare_payoff(batch, shadow, lane, delta[lane]);
+                    live -= 1 - start(batch, shadows, lane, next, hands, rng);
+                }
+            }
+        }
+
+        std::cout << name_ << ": " << (mismatches_ == 0 ? "ok" : "FAILED") << " (" << hands << " hands, "
+                  << actions_ << " actions, " << mismatches_ << " mismatches)\n";
+        return mismatches_ == 0 && finished_ == hands;
+    }
+
+private:
+    bool start(poker::StateBatch& batch, std::vector<Shadow>& shadows, std::size_t lane, std::uint64_t& next,
+               std::uint64_t hands, poker::Xoshiro256StarStar& rng) {
+        if (next == hands) {
+            batch.retire(lane);
+            return false;
+        }
+        Shadow& shadow = shadows[lane];
+        shadow.hand = next++;
+        batch.reset(lane, poker::split_mix64(shadow.hand));
+        shadow.state = rules_.new_hand(rng);
+        copy_cards(batch.state(lane), shadow.state);
+        compare_state(batch, shadow, lane, batch.state(lane));
+        return true;
+    }
+
+    // Checks the lane's legal set against Rules and picks one of its actions for both.
+    void choose(poker::StateBatch& batch, Shadow& shadow, std::size_t lane, poker::Xoshiro256StarStar& rng) {
+        std::vector<poker::Action> batch_legal;
+        std::vector<poker::BatchAction> choices;
+        for (int k = 0; k < poker::kBatchActions; ++k) {
+            if ((batch.legal_mask(lane) >> k) & 1U) {
+                const auto a = static_cast<poker::BatchAction>(k);
+                batch_legal.push_back(batch.action(lane, a));
+                choices.push_back(a);
+            }
+        }
+        if (sorted_actions(batch_legal) != sorted_actions(rules_.legal_actions(shadow.state))) {
+            fail(shadow, "legal actions differ");
+        }
+
+        const poker::BatchAction choice = choices[poker::uniform_below(rng, static_cast<std::uint32_t>(choices.size()))];
+        batch.set_choice(lane, choice);
+        if (!rules_.apply_action(shadow.state, batch.action(lane, choice), rng)) {
+            fail(shadow, "Rules rejects the batch action");
+        }
+        ++actions_;
+    }
+
+    void compare_state(const poker::StateBatch& batch, const Shadow& shadow, std::size_t lane,
+                       const poker::State& lane_state) {
+        if (betting_fields(lane_state) != betting_fields(shadow.state)) {
+            fail(shadow, "betting state differs");
+        }
+        if (static_cast<std::size_t>(batch.actions(lane)) != shadow.state.history.size()) {
+            fail(shadow, "action count differs");
+        }
+    }
+
+    void compare_payoff(const poker::StateBatch& batch, const Shadow& shadow, std::size_t lane, std::int32_t delta) {
+        const poker::TerminalResult r = rules_.terminal_payoff(shadow.state);
+        if (!r.is_terminal || r.winner != batch.winner(lane) || r.chip_delta[0] != delta ||
+            batch.folded(lane) != (shadow.state.folded[0] || shadow.state.folded[1])) {
+            fail(shadow, "payoff differs");
+        }
+        ++finished_;
+    }
+
+    void fail(const Shadow& shadow, const char* what) {
+        if (mismatches_++ < 10) {
+            std::cout << name_ << ": hand " << shadow.hand << ": " << what << "\n";
+        }
+    }
+
+    std::string name_;
+    poker::Rules rules_;
+    std::uint64_t actions_ = 0;
+    std::uint64_t finished_ = 0;
+    std::uint64_t mismatches_ = 0;
+};
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok &= Checker("default rules", poker::RulesConfig{}).run(256, 200000);
+
+    poker::RulesConfig capped;
+    capped.bet_sizes = {0.33, 0.75, 1.5};
+    capped.max_raises_per_street = 2;
+    capped.allow_all_in = false;
+    ok &= Checker("capped raises, no all-in", capped).run(256, 200000);
+
+    poker::RulesConfig deep;
+    deep.starting_stack = 20000;
+    deep.small_blind = 1;
+    deep.big_blind = 2;
+    ok &= Checker("deep stacks", deep).run(100, 100000);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// Checks that the parallel tree builder reproduces the serial tree node for node, for any
+// worker count, and that TreeBuilder::estimate counts the same tree.
+
+#include "poker/static_abstraction.hpp"
+#include "poker/tree.hpp"
+#include "poker/zobrist.hpp"
+#include "tree_builder_parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+auto fields(const poker::TreeNode& n) {
+    return std::tie(n.first_child, n.child_count, n.type, n.street, n.player, n.to_call, n.terminal);
+}
+
+auto fields(const poker::TreeAction& a) {
+    return std::tie(a.amount, a.type);
+}
+
+auto fields(const poker::TerminalData& t) {
+    return std::tie(t.kind, t.winner, t.pot, t.committed_total, t.chip_delta_if_forced);
+}
+
+auto fields(const poker::TreeState& s) {
+    return std::tie(s.street, s.pot, s.stacks, s.to_act, s.bet_to_call, s.last_bet_size, s.current_bet,
+                    s.committed_this_round, s.committed_total, s.folded, s.acted_this_round,
+                    s.raises_this_street, s.hash);
+}
+
+std::int32_t fields(std::int32_t child) {
+    return child;
+}
+
+template <typename T>
+std::size_t count_mismatches(const std::vector<T>& expected, const std::vector<T>& actual) {
+    if (expected.size() != actual.size()) {
+        return std::max(expected.size(), actual.size());
+    }
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        mismatches += fields(expected[i]) != fields(actual[i]);
+    }
+    return mismatches;
+}
+
+bool same_tree(const std::string& name, const poker::GameTree& serial, const poker::GameTree& parallel) {
+    const std::size_t mismatches = (serial.root_id != parallel.root_id) +
+                                   count_mismatches(serial.nodes, parallel.nodes) +
+                                   count_mismatches(serial.actions, parallel.actions) +
+                                   count_mismatches(serial.children, parallel.children) +
+                                   count_mismatches(serial.terminals, parallel.terminals) +
+                                   count_mismatches(serial.states, parallel.states);
+    std::cout << name << ": " << (mismatches == 0 ? "ok" : "FAILED") << " (" << parallel.nodes.size()
+              << " nodes, " << parallel.children.size() << " edges, " << parallel.terminals.size()
+              << " terminals, " << mismatches << " mismatches)\n";
+    return mismatches == 0;
+}
+
+// TreeBuilder::estimate must count exactly the tree build() returns, and stop at its limit.
+bool check_estimate(const std::string& name, const poker::TreeBuilder& builder, const poker::GameTree& tree) {
+    poker::TreeEstimate expected;
+    for (const poker::TreeNode& n : tree.nodes) {
+        ++expected.nodes[static_cast<std::size_t>(n.street)][static_cast<std::size_t>(n.type)];
+        if (n.type == poker::NodeType::Decision) {
+            expected.decision_edges += n.child_count;
+        }
+    }
+    expected.edges = tree.children.size();
+    const std::size_t bytes = tree.nodes.size() * sizeof(poker::TreeNode) +
+                              tree.actions.size() * sizeof(poker::TreeAction) +
+                              tree.children.size() * sizeof(std::int32_t) +
+                              tree.terminals.size() * sizeof(poker::TerminalData);
+
+    const poker::TreeEstimate estimate = builder.estimate();
+    const bool counts = !estimate.over_limit && estimate.nodes == expected.nodes && estimate.edges == expected.edges &&
+                        estimate.decision_edges == expected.decision_edges && estimate.tree_bytes() == bytes;
+    const bool limit = !builder.estimate(tree.nodes.size()).over_limit &&
+                       builder.estimate(tree.nodes.size() - 1).over_limit &&
+                       builder.estimate(tree.nodes.size() - 1).total_nodes() == tree.nodes.size() - 1;
+    std::cout << name << ", estimate: " << (counts && limit ? "ok" : "FAILED") << " (" << estimate.total_nodes()
+              << " nodes, " << estimate.edges << " edges, " << estimate.tree_bytes() << " bytes"
+              << (limit ? "" : ", wrong limit") << ")\n";
+    return counts && limit;
+}
+
+bool check_builder(const std::string& name, const poker::TreeBuilder& builder, const poker::BettingAbstraction& ab,
+                   poker::TreeBuilder::ActionGenerator generate, std::size_t max_nodes) {
+    poker::TreeBuildOptions options;
+    options.max_nodes = max_nodes;
+    options.keep_states = true;
+    const poker::GameTree serial = builder.build(options);
+
+    bool ok = serial.nodes.size() > 1;
+    // The builder keeps TreeState::hash incrementally; it must match a from-scratch hash.
+    std::size_t hash_mismatches = 0;
+    for (const poker::TreeState& st : serial.states) {
+        hash_mismatches += st.hash != poker::zobrist::betting_hash(st);
+    }
+    std::cout << name << ", state hashes: " << (hash_mismatches == 0 ? "ok" : "FAILED") << " ("
+              << hash_mismatches << " mismatches)\n";
+    ok &= hash_mismatches == 0;
+    ok &= check_estimate(name, builder, serial);
+    for (int threads : {1, 2, 3, 8}) {
+        // The parallel builder directly, since TreeBuilder::build runs one thread serially.
+        const poker::GameTree parallel = poker::detail::build_parallel(ab, generate, options, threads);
+        ok &= same_tree(name + ", " + std::to_string(threads) + " workers", serial, parallel);
+    }
+    options.threads = 4;
+    options.keep_states = false;
+    poker::GameTree expected = serial;
+    expected.states.clear();
+    ok &= same_tree(name + ", TreeBuilder::build with 4 threads", expected, builder.build(options));
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+
+    const poker::BettingAbstraction ab = poker::TreeBuilder::default_abstraction();
+    ok &= check_builder("default abstraction", poker::TreeBuilder(ab), ab, nullptr, 200000);
+
+    // The poker_solve tree.
+    using HalfAndPot = poker::SizeList<poker::PotFraction<1, 2>, poker::PotFraction<1>>;
+    using Pot = poker::SizeList<poker::PotFraction<1>>;
+    using Sizes = poker::StreetSizes<HalfAndPot, HalfAndPot, Pot, Pot>;
+    const poker::StaticAbstraction<Sizes> solve;
+    ok &= check_builder("static abstraction", poker::make_tree_builder(solve), solve.runtime(),
+                        &poker::StaticAbstraction<Sizes>::legal_actions, 300000);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// Round-trips a tree through a tree file and checks that corrupted files are rejected by
+// MappedGameTree::open, with and without the checksum.
+
+#include "poker/tree.hpp"
+#include "poker/tree_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<char> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+bool opens(const std::string& path, bool verify_checksum) {
+    try {
+        poker::MappedGameTree::open(path, verify_checksum);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+template <typename T>
+void put(std::vector<char>& bytes, std::size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+} // namespace
+
+int main() {
+    const std::string path = "tree_file_test.bin";
+    const std::string corrupt_path = "tree_file_test_corrupt.bin";
+    const poker::GameTree tree = poker::TreeBuilder(poker::TreeBuilder::default_abstraction()).build();
+    poker::write_game_tree(path, tree);
+
+    bool ok = true;
+    {
+        const poker::MappedGameTree mapped = poker::MappedGameTree::open(path);
+        const poker::GameTreeView& view = mapped.tree();
+        bool same = view.root_id == tree.root_id && view.nodes.size() == tree.nodes.size() &&
+                    view.children.size() == tree.children.size() && view.terminals.size() == tree.terminals.size();
+        for (std::size_t i = 0; same && i < tree.nodes.size(); ++i) {
+            same = std::memcmp(&view.nodes[i], &tree.nodes[i], sizeof(poker::TreeNode)) == 0;
+        }
+        for (std::size_t i = 0; same && i < tree.children.size(); ++i) {
+            same = view.children[i] == tree.children[i] && view.actions[i].amount == tree.actions[i].amount &&
+                   view.actions[i].type == tree.actions[i].type;
+        }
+        std::cout << "round trip: " << (same ? "ok" : "FAILED") << "\n";
+        ok &= same;
+    }
+
+    const std::vector<char> original = read_file(path);
+    const std::size_t nodes_at = sizeof(poker::TreeFileHeader);
+    const std::size_t node_bytes = sizeof(poker::TreeNode);
+    const std::size_t children_at = nodes_at + (tree.nodes.size() * node_bytes + 7) / 8 * 8 +
+                                    (tree.actions.size() * sizeof(poker::TreeAction) + 7) / 8 * 8;
+    std::size_t decision = 0;
+    std::size_t terminal = 0;
+    for (std::size_t i = 0; i < tree.nodes.size(); ++i) {
+        if (tree.nodes[i].type == poker::NodeType::Decision) {
+            decision = i;
+        } else if (tree.nodes[i].type == poker::NodeType::Terminal) {
+            terminal = i;
+        }
+    }
+
+    struct Corruption {
+        const char* name;
+        std::function<void(std::vector<char>&)> apply;
+    };
+    const std::vector<Corruption> corruptions = {
+        {"byte order",
+         [](std::vector<char>& b) {
+             put<std::uint32_t>(b, offsetof(poker::TreeFileHeader, byte_order), 0x04030201);
+         }},
+        {"child out of range",
+         [&](std::vector<char>& b) {
+             put<std::int32_t>(b, children_at, static_cast<std::int32_t>(tree.nodes.size()));
+         }},
+        {"negative child", [&](std::vector<char>& b) { put<std::int32_t>(b, children_at, -1); }},
+        {"edges past the end",
+         [&](std::vector<char>& b) {
+             put<std::uint32_t>(b, nodes_at + decision * node_bytes + offsetof(poker::TreeNode, first_child),
+                                static_cast<std::uint32_t>(tree.children.size()));
+         }},
+        {"terminal out of range",
+         [&](std::vector<char>& b) {
+             put<std::int32_t>(b, nodes_at + terminal * node_bytes + offsetof(poker::TreeNode, terminal),
+                               static_cast<std::int32_t>(tree.terminals.size()));
+         }},
+        {"node type",
+         [&](std::vector<char>& b) {
+             put<std::uint8_t>(b, nodes_at + decision * node_bytes + offsetof(poker::TreeNode, type), 7);
+         }},
+    };
+    for (const Corruption& c : corruptions) {
+        std::vector<char> bytes = original;
+        c.apply(bytes);
+        write_file(corrupt_path, bytes);
+        const bool rejected = !opens(corrupt_path, true) && !opens(corrupt_path, false);
+        std::cout << c.name << ": " << (rejected ? "ok" : "FAILED (accepted)") << "\n";
+        ok &= rejected;
+    }
+
+    std::remove(path.c_str());
+    std::remove(corrupt_path.c_str());
+    return ok ? 0 : 1;
+}